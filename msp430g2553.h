@@ -22,6 +22,18 @@
 #define __READ const
 #endif
 
+#define MSP430_CONCAT_(a, b) a##b
+#define MSP430_CONCAT(a, b)  MSP430_CONCAT_(a, b)
+
+/* Compile-time check of a constant expression */
+#if defined(__cplusplus) && (__cplusplus >= 201103L)
+#define MSP430_STATIC_ASSERT(cond, msg) static_assert(cond, msg)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define MSP430_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
+#else
+#define MSP430_STATIC_ASSERT(cond, msg) typedef char MSP430_CONCAT(msp430_static_assert_, __LINE__)[(cond) ? 1 : -1]
+#endif
+
 /*****************************************************************************
 * @brief Status register bits
 *****************************************************************************/
@@ -67,6 +79,10 @@
 #define TLV_BCS_CLK_1M     (3U) /* Basic Clock Module+ cal. values: 1MHz */
 #define TLV_BCS_CLK_NUMBER (4U) /* Calibration values number */
 
+/* DCO frequency of a TLV_BCS_CLK_x calibration entry */
+#define TLV_BCS_CLK_HZ(idx) \
+  (((idx) == TLV_BCS_CLK_16M) ? 16000000UL : ((idx) == TLV_BCS_CLK_12M) ? 12000000UL : ((idx) == TLV_BCS_CLK_8M) ? 8000000UL : 1000000UL)
+
 typedef struct
 {
     __READ uint16_t VREF_FACTOR; /* Ref. Factor */
@@ -289,6 +305,30 @@ typedef struct
 #define TA_BASE_ADDRS {TA0_BASE, TA1_BASE}
 #define TA_BASE_PTRS  {TA0, TA1}
 
+/* Software timer for the TA_TIMER_* macros */
+typedef struct TA_TIMER
+{
+    struct TA_TIMER        *NEXT;   /* Later timer, maintained by the service */
+    struct TA_TIMER        *PREV;   /* Earlier timer, maintained by the service */
+    uint32_t                DUE;    /* Expiry in timer ticks */
+    void (*FN)(struct TA_TIMER *timer); /* Called from the timer interrupt on expiry */
+} TA_TIMER_Type;
+
+/* Timer service state: pending timers sorted by DUE */
+typedef struct
+{
+    TA_TIMER_Type          *HEAD;   /* Earliest pending timer */
+    TA_TIMER_Type          *TAIL;   /* Latest pending timer */
+    uint16_t                HI;     /* Upper half of the extended counter */
+    uint16_t                LAST;   /* Counter at the last extension */
+} TA_TIMERS_Type;
+
+/* PWM compare values staged for the next TA_PWM_IRQ commit */
+typedef struct
+{
+    uint16_t                CCR[2]; /* CCR1, CCR2 */
+} TA_PWM_Type;
+
 /*****************************************************************************
 * @brief USCI UART Mode
 *****************************************************************************/
@@ -313,6 +353,21 @@ typedef struct
 #define USCI_UART_BASE_ADDRS {UCA0_UART_BASE}
 #define USCI_UART_BASE_PTRS  {UCA0_UART}
 
+/* LIN slave frame state for LIN_SLAVE_RX */
+typedef struct LIN_SLAVE
+{
+    uint8_t                 STATE;  /* LIN_SLAVE_STATE_*, maintained by the handler */
+    uint8_t                 PID;    /* Protected identifier of the current frame */
+    uint8_t                 MODE;   /* LIN_SLAVE_PUBLISH or LIN_SLAVE_SUBSCRIBE */
+    uint8_t                 LEN;    /* Data bytes of the current frame, 1 .. 8 */
+    uint8_t                 POS;    /* Data bytes done */
+    uint16_t                SUM;    /* Running checksum */
+    uint8_t                 DATA[8]; /* Response sent (publish) or received (subscribe) */
+    uint8_t (*LOOKUP)(struct LIN_SLAVE *lin); /* Called with PID and LEN set, returns LIN_SLAVE_* */
+    void (*DONE)(struct LIN_SLAVE *lin); /* Called after a subscribed frame with a good checksum, may be 0 */
+    volatile uint8_t        ERRORS; /* Frames dropped on bit, checksum, framing or header errors */
+} LIN_SLAVE_Type;
+
 /*****************************************************************************
 * @brief USCI SPI Mode
 *****************************************************************************/
@@ -337,6 +392,21 @@ typedef struct
 #define UCSI_SPI_BASE_ADDRS {UCA0_SPI_BASE, UCB0_SPI_BASE}
 #define USCI_SPI_BASE_PTRS  {UCA0_SPI, UCB0_SPI}
 
+/* SPI transaction descriptor for the USCI_SPI_QUEUE_* macros */
+typedef struct USCI_SPI_XFER
+{
+    uint8_t                 CTL0;   /* UCxCTL0 for the device: UCCKPH, UCCKPL, UCMSB, UCMST, UCSYNC */
+    uint8_t                 BR0;    /* Prescaler low byte */
+    uint8_t                 BR1;    /* Prescaler high byte */
+    uint8_t                 CS;     /* Chip-select pin mask, active low */
+    volatile uint8_t       *CS_OUT; /* Port output register of the chip select */
+    const uint8_t          *TX;     /* Bytes to send, 0 sends 0xff */
+    uint8_t                *RX;     /* Received bytes, 0 discards them */
+    uint16_t                LEN;    /* Transfer length, at least 1 */
+    uint16_t                POS;    /* Bytes done, maintained by the queue */
+    void (*DONE)(struct USCI_SPI_XFER *xfer); /* Called from the RX handler on completion, may be 0 */
+} USCI_SPI_XFER_Type;
+
 /*****************************************************************************
 * @brief UCSI I2C Mode
 *****************************************************************************/
@@ -367,6 +437,39 @@ typedef struct
 #define UCSI_I2C_BASE_ADDRS {UCB0_I2C_BASE}
 #define USCI_I2C_BASE_PTRS  {UCB0_I2C}
 
+/* I2C master transaction descriptor for the USCI_I2C_MASTER_* macros */
+typedef struct USCI_I2C_XFER
+{
+    uint8_t                 ADDR;   /* 7-bit slave address */
+    volatile uint8_t        STATUS; /* USCI_I2C_STATUS_* */
+    uint8_t                 TXLEN;  /* Bytes written first, e.g. the register pointer */
+    uint8_t                 RXLEN;  /* Bytes read after a repeated start */
+    const uint8_t          *TX;
+    uint8_t                *RX;
+    uint8_t                 POS;    /* Bytes done in the current phase, maintained by the queue */
+    void (*DONE)(struct USCI_I2C_XFER *xfer); /* Called from interrupt context on completion, may be 0 */
+    uint8_t                 TRIES;  /* Retries left after lost arbitration */
+} USCI_I2C_XFER_Type;
+
+/* I2C slave register map for the USCI_I2C_SLAVE_* macros. Registers
+  0 .. RO - 1 are read-only and served from SNAP[FRONT], RO .. WO - 1
+  are read/write and WO .. SIZE - 1 write-only, both stored in CTL. */
+typedef struct
+{
+    uint8_t                *SNAP[2]; /* Read-only registers, double buffered */
+    uint8_t                *CTL;     /* Registers RO .. SIZE - 1 */
+    uint8_t                 RO;      /* First read/write register */
+    uint8_t                 WO;      /* First write-only register */
+    uint8_t                 SIZE;    /* Number of registers */
+    volatile uint8_t        FRONT;   /* SNAP buffer the master reads */
+    volatile uint8_t        PENDING; /* Set by the application to publish the other SNAP buffer */
+    volatile uint8_t        WRITTEN; /* Set at STOP after the master wrote registers */
+    uint8_t                 PTR;     /* Register pointer */
+    uint8_t                 FIRST;   /* Next received byte is the register pointer */
+    uint8_t                 DIRTY;   /* Registers written in the current transaction */
+    uint8_t                 READ;    /* A read transaction is in progress */
+} USCI_I2C_SLAVE_Type;
+
 /*****************************************************************************
 * @brief Watchdog Timer
 *****************************************************************************/
@@ -704,6 +807,86 @@ typedef struct
 #define ADC10_CTL0_SREF_VEREF_VREF     (6U) /* Select reference: VR+ = VeREF+ and VR- = VREF-/ VeREF-. Devices with VeREF+ and VeREF- pins only */
 #define ADC10_CTL0_SREF_BUF_VEREF_VREF (7U) /* Select reference: VR+ = Buffered VeREF+ and VR- = VREF-/ VeREF-. Devices with VeREF+ and VeREF- pins only */
 
+/* ADC10 internal reference.
+  The reference generator needs ADC10_REF_SETTLE_US after REFON is set
+  before the first conversion. Wait for it with a timer compare
+  (ADC10_REF_SETTLE_TICKS) and a low power mode, not a busy loop. Turn
+  REFON off once the last user is done. For sparse readings, REFBURST
+  powers the reference buffer only during sample-and-conversion, and
+  ADC10SR lowers its current when sampling at 50 ksps or less. REFON,
+  REF2_5V, REFBURST and ADC10SR can be modified only when ENC = 0. */
+#define ADC10_REF_SETTLE_US (30U) /* Internal reference settling time, tREFON max */
+
+/* Timer clocks (at fclk Hz) covering ADC10_REF_SETTLE_US, rounded up */
+#define ADC10_REF_SETTLE_TICKS(fclk) ((((fclk) * ADC10_REF_SETTLE_US) + 999999UL) / 1000000UL)
+
+/* CTL0 reference bits for the internal 1.5 V (v2_5 = 0) or 2.5 V (v2_5 = 1)
+  reference, with the buffer on only while converting when burst = 1 */
+#define ADC10_CTL0_INTERNAL_REF(v2_5, burst) \
+  (ADC10_CTL0_SREF(ADC10_CTL0_SREF_VREF_AVSS) | ADC10_CTL0_REFON(1U) | ADC10_CTL0_REF2_5V(v2_5) | ADC10_CTL0_REFBURST(burst))
+
+/* All reference related CTL0 bits, to clear before switching references */
+#define ADC10_CTL0_REF_MASK \
+  (ADC10_CTL0_SREF_MASK | ADC10_CTL0_REFON_MASK | ADC10_CTL0_REF2_5V_MASK | ADC10_CTL0_REFBURST_MASK | ADC10_CTL0_ADC10SR_MASK)
+
+/* Reference users share a caller-owned uint8_t count, and all of them
+  get the reference the first user configured. ADC10_REF_ACQUIRE turns
+  the reference on for the first user and sets status to
+  ADC10_REF_STATUS_SETTLE, in which case the first conversion waits
+  ADC10_REF_SETTLE_TICKS on a timer (e.g. TA_TIMER_START). A later user
+  asking for the same voltage and sps class gets ADC10_REF_STATUS_READY.
+  One asking for a different REF2_5V, REFBURST or ADC10SR setting is not
+  counted and gets ADC10_REF_STATUS_CONFLICT; it has to wait until the
+  count drops to 0 and retry. REFBURST and ADC10SR follow the sample
+  rate sps in samples per second: at or below ADC10_REF_BURST_MAX_SPS a
+  conversion takes only a small part of the sample period, so the buffer
+  is powered only while converting.
+  ADC10_REF_RELEASE turns the reference off when the count drops to 0.
+  Both clear ENC before writing CTL0 when the reference state changes.
+  The count is a plain read-modify-write: use it from one context, or
+  mask the interrupts of the other users around the calls. */
+#ifndef ADC10_REF_BURST_MAX_SPS
+#define ADC10_REF_BURST_MAX_SPS (10000UL)
+#endif
+
+#define ADC10_REF_BURST_FOR(sps) (((sps) <= ADC10_REF_BURST_MAX_SPS) ? 1U : 0U)
+#define ADC10_REF_SR_FOR(sps)    (((sps) <= 50000UL) ? 1U : 0U)
+
+#define ADC10_REF_STATUS_READY    (0U) /* Reference shared, already settled */
+#define ADC10_REF_STATUS_SETTLE   (1U) /* Reference turned on, wait ADC10_REF_SETTLE_TICKS */
+#define ADC10_REF_STATUS_CONFLICT (2U) /* Reference in use with other settings, not acquired */
+
+/* CTL0 bits that must match between users of a shared reference */
+#define ADC10_REF_MODE_MASK (ADC10_CTL0_REF2_5V_MASK | ADC10_CTL0_REFBURST_MASK | ADC10_CTL0_ADC10SR_MASK)
+#define ADC10_REF_MODE(v2_5, sps) \
+  (ADC10_CTL0_REF2_5V(v2_5) | ADC10_CTL0_REFBURST(ADC10_REF_BURST_FOR(sps)) | ADC10_CTL0_ADC10SR(ADC10_REF_SR_FOR(sps)))
+
+#define ADC10_REF_ACQUIRE(cnt, v2_5, sps, status)                                                         \
+  do {                                                                                                    \
+    if ((cnt) == 0U) {                                                                                    \
+      ADC10->CTL0 &= (uint16_t)~ADC10_CTL0_ENC_MASK;                                                      \
+      ADC10->CTL0 = (uint16_t)((ADC10->CTL0 & (uint16_t)~ADC10_CTL0_REF_MASK) |                           \
+                               ADC10_CTL0_INTERNAL_REF(v2_5, ADC10_REF_BURST_FOR(sps)) |                  \
+                               ADC10_CTL0_ADC10SR(ADC10_REF_SR_FOR(sps)));                                \
+      (cnt) = 1U;                                                                                         \
+      (status) = ADC10_REF_STATUS_SETTLE;                                                                 \
+    } else if ((ADC10->CTL0 & ADC10_REF_MODE_MASK) != ADC10_REF_MODE(v2_5, sps)) {                        \
+      (status) = ADC10_REF_STATUS_CONFLICT;                                                               \
+    } else {                                                                                              \
+      (cnt)++;                                                                                            \
+      (status) = ADC10_REF_STATUS_READY;                                                                  \
+    }                                                                                                     \
+  } while (0)
+
+#define ADC10_REF_RELEASE(cnt)                                                                            \
+  do {                                                                                                    \
+    if ((cnt) != 0U && --(cnt) == 0U) {                                                                   \
+      ADC10->CTL0 &= (uint16_t)~ADC10_CTL0_ENC_MASK;                                                      \
+      ADC10->CTL0 &=                                                                                      \
+        (uint16_t)~(ADC10_CTL0_REFON_MASK | ADC10_CTL0_REFBURST_MASK | ADC10_CTL0_ADC10SR_MASK);          \
+    }                                                                                                     \
+  } while (0)
+
 /*****************************************************************************
  * @brief ADC10_CTL1
  *****************************************************************************/
@@ -839,6 +1022,46 @@ typedef struct
 #define ADC10_CTL1_CONSEQ_REPEAT_SINGLE   (2U) /* Conversion sequence mode select: Repeat-single-channel mode */
 #define ADC10_CTL1_CONSEQ_REPEAT_SEQUENCE (3U) /* Conversion sequence mode select: Repeat-sequence-of-channels mode */
 
+/* ADC10_CTL1_TA_TRIGGERED */
+/* Repeat-single-channel conversions of channel inch, each one started in
+  hardware by the rising edge of Timer0_A OUT1. With TA0 in up mode and
+  CCR1 in TA_CCTL_OUTMOD_PWM_RESET_SET, OUT1 rises at every CCR0 period
+  start, so the sample rate is set by TA_CTL_UP_RATE/TA_CCR0_FOR with no
+  ISR involved per sample. Keep MSC = 0 and CCR1 between 1 and CCR0. */
+#define ADC10_CTL1_TA_TRIGGERED(inch) \
+  (ADC10_CTL1_INCH(inch) | ADC10_CTL1_SHS(ADC10_CTL1_SHS_TA_OUT1) | ADC10_CTL1_CONSEQ(ADC10_CTL1_CONSEQ_REPEAT_SINGLE))
+
+/* ADC10_SEQ_INCH */
+/* Highest channel of an A0-A7 channel bitmap (as written to ADC10_AE0),
+  i.e. the INCH value for a sequence covering all of its channels */
+#define ADC10_SEQ_INCH(map) \
+  (((map) & 0x80U) ? 7U : ((map) & 0x40U) ? 6U : ((map) & 0x20U) ? 5U : ((map) & 0x10U) ? 4U : \
+   ((map) & 0x08U) ? 3U : ((map) & 0x04U) ? 2U : ((map) & 0x02U) ? 1U : 0U)
+
+/* ADC10_SEQ_LENGTH */
+/* Conversions per sequence. A sequence always runs from INCH down to A0,
+  channels missing from the bitmap included. */
+#define ADC10_SEQ_LENGTH(inch) ((inch) + 1U)
+
+/* ADC10_SEQ_SAMPLE */
+/* Result of channel ch in sequence number seq of a DTC buffer filled in
+  sequence mode. Channels come out highest first, so the result is read
+  in place and nothing is copied to de-interleave the buffer. */
+#define ADC10_SEQ_SAMPLE(buf, inch, seq, ch) ((buf)[((seq) * ADC10_SEQ_LENGTH(inch)) + ((inch) - (ch))])
+
+/* ADC10_CTL1_SCAN */
+/* Sequence-of-channels mode over all channels of an A0-A7 bitmap. With
+  MSC = 1, each trigger converts INCH down to A0 once, back to back, then
+  the ADC10 stops. ADC10SC starts the next burst directly; with an SHI
+  source (timer output) ENC has to be toggled before the next edge is
+  accepted. For timer-paced scans use ADC10_CTL1_CONSEQ_REPEAT_SEQUENCE with
+  MSC = 0 instead: every SHI edge then converts one channel. Repeat mode
+  with MSC = 1 converts continuously until ENC is cleared and ignores
+  further SHI edges. The DTC (ADC10_DTC1 = sequences * ADC10_SEQ_LENGTH)
+  raises one interrupt per block in either case. */
+#define ADC10_CTL1_SCAN(map) \
+  (ADC10_CTL1_INCH(ADC10_SEQ_INCH(map)) | ADC10_CTL1_CONSEQ(ADC10_CTL1_CONSEQ_SEQUENCE))
+
 /*****************************************************************************
  * @brief ADC10_MEM
  *****************************************************************************/
@@ -852,6 +1075,29 @@ typedef struct
   format. Bit 15 is the MSB. Bits 5-0 are always 0. */
 #define ADC10_MEM(x)    (((uint16_t)(((uint16_t)(x)) << ADC10_MEM_SHIFT)) & ADC10_MEM_MASK)
 
+/* ADC10 oversampling and decimation.
+  Summing 4^b straight-binary results and shifting the sum right by b
+  gives a (10 + b)-bit result, provided the input carries at least 1 LSB
+  of noise. The sum is (10 + 2b) bits wide, so a uint16_t accumulator is
+  enough up to b = 3 and a uint32_t one is needed above. Setting
+  ADC10_DTC1 to ADC10_OVERSAMPLE_COUNT(b) (b <= 3) makes every DTC block
+  exactly one output sample (accumulate and dump). */
+#define ADC10_OVERSAMPLE_COUNT(b)    (1U << (2U * (b)))         /* Conversions per output sample */
+#define ADC10_OVERSAMPLE_ACC_BITS(b) (10U + (2U * (b)))         /* Width of the sum */
+#define ADC10_DECIMATE(acc, b)       ((acc) >> (b))             /* (10 + b)-bit result from the sum */
+
+/* Adds n results from a DTC block to acc with adds only */
+#define ADC10_ACCUMULATE(acc, block, n)                \
+  do                                                   \
+  {                                                    \
+    const volatile uint16_t *adc10_p_ = (block);       \
+    uint16_t                 adc10_n_ = (uint16_t)(n); \
+    while (adc10_n_-- != 0U)                           \
+    {                                                  \
+      (acc) += *adc10_p_++;                            \
+    }                                                  \
+  } while (0)
+
 /*****************************************************************************
  * @brief ADC10_DTC0
  *****************************************************************************/
@@ -891,6 +1137,57 @@ typedef struct
 /* This bit should normally be reset. */
 #define ADC10_DTC0_ADC10FETCH(x)    (((uint8_t)(((uint8_t)(x)) << ADC10_DTC0_ADC10FETCH_SHIFT)) & ADC10_DTC0_ADC10FETCH_MASK)
 
+/* ADC10_DTC0 two-block continuous (ping-pong) mode.
+  The DTC fills block 1 (n words from ADC10SA) and block 2 (the next n
+  words) alternately until ADC10CT is cleared, n being the ADC10_DTC1
+  transfer count. ADC10IFG is set once per completed block, so the CPU
+  wakes once per n conversions instead of once per conversion. Each
+  completed block stays untouched for the next n conversion periods. */
+#define ADC10_DTC0_PINGPONG (ADC10_DTC0_ADC10TB(1U) | ADC10_DTC0_ADC10CT(1U))
+
+/* Block just completed by the DTC in two-block mode, valid in the ADC10
+  interrupt. buf is the uint16_t buffer written to ADC10SA and n the
+  ADC10_DTC1 transfer count. No data is copied. */
+#define ADC10_DTC_FILLED_BLOCK(buf, n) \
+  (((ADC10->DTC0 & ADC10_DTC0_ADC10B1_MASK) != 0U) ? (buf) : ((buf) + (n)))
+
+/*****************************************************************************
+ * @brief ADC10_DTC1
+ *****************************************************************************/
+
+ /* ADC10_DTC1_ADC10DTC */
+#define ADC10_DTC1_ADC10DTC_MASK  (0xffU)
+#define ADC10_DTC1_ADC10DTC_SHIFT (0x0U)
+/* DTC transfers. These bits define the number of transfers in each block.
+  0h = DTC is disabled
+  01h-0FFh = Number of transfers per block */
+#define ADC10_DTC1_ADC10DTC(x)    (((uint8_t)(((uint8_t)(x)) << ADC10_DTC1_ADC10DTC_SHIFT)) & ADC10_DTC1_ADC10DTC_MASK)
+
+/*****************************************************************************
+ * @brief ADC10_AE0
+ *****************************************************************************/
+
+ /* ADC10_AE0_ADC10AE0 */
+#define ADC10_AE0_ADC10AE0_MASK  (0xffU)
+#define ADC10_AE0_ADC10AE0_SHIFT (0x0U)
+/* ADC10 analog enable. These bits enable the corresponding pin for
+  analog input. BIT0 corresponds to A0, BIT1 corresponds to A1, etc.
+  0b = Analog input disabled
+  1b = Analog input enabled */
+#define ADC10_AE0_ADC10AE0(x)    (((uint8_t)(((uint8_t)(x)) << ADC10_AE0_ADC10AE0_SHIFT)) & ADC10_AE0_ADC10AE0_MASK)
+
+/*****************************************************************************
+ * @brief ADC10_SA
+ *****************************************************************************/
+
+ /* ADC10_SA_ADC10SA */
+#define ADC10_SA_ADC10SA_MASK  (0xfffeU)
+#define ADC10_SA_ADC10SA_SHIFT (0x0U)
+/* ADC10 start address. These bits are the start address for the DTC.
+  A write to ADC10SA is required to initiate DTC transfers, so it must be
+  written after ADC10_DTC0 and ADC10_DTC1. */
+#define ADC10_SA_ADC10SA(x)    (((uint16_t)(((uint16_t)(x)) << ADC10_SA_ADC10SA_SHIFT)) & ADC10_SA_ADC10SA_MASK)
+
 /*****************************************************************************
 * @brief BCS_DCOCTL
 *****************************************************************************/
@@ -1114,12 +1411,208 @@ typedef struct
 #define BCS_CTL3_XT2S_3_16MHZ (2U) /* XT2 range select: 3- to 16-MHz crystal or resonator */
 #define BCS_CTL3_XT2S_EXT     (3U) /* XT2 range select: Digital external 0.4- to 16-MHz clock source */
 
+/* BCS_CTL3_LFXT1S */
+#define BCS_CTL3_LFXT1S_32K_CRYSTAL (0U) /* Low-frequency clock select: 32768-Hz crystal on LFXT1 (XTS = 0) */
+#define BCS_CTL3_LFXT1S_RESERVED    (1U) /* Low-frequency clock select: Reserved (XTS = 0) */
+#define BCS_CTL3_LFXT1S_VLOCLK      (2U) /* Low-frequency clock select: VLOCLK (XTS = 0) */
+#define BCS_CTL3_LFXT1S_EXT         (3U) /* Low-frequency clock select: Digital external clock source (XTS = 0) */
+
 /* BCS_CTL3_XCAP */
 #define BCS_CTL3_XCAP_1PF  (0U) /* Oscillator capacitor selection: 1 pF */
 #define BCS_CTL3_XCAP_6PF  (1U) /* Oscillator capacitor selection: 6 pF */
 #define BCS_CTL3_XCAP_10PF (2U) /* Oscillator capacitor selection: 10 pF */
 #define BCS_CTL3_XCAP_12PF (3U) /* Oscillator capacitor selection: 12.5 pF */
 
+/*****************************************************************************
+* @brief Clock tree
+*****************************************************************************/
+
+/* Compile-time clock configuration. Define any of the MSP430_DCOCLK_HZ,
+  MSP430_LFXT1CLK_HZ and MSP430_BCS_* values before including this header
+  to describe the BCS setup the application programs; the defaults are
+  the PUC state with the DCO calibrated to 1 MHz and a 32768 Hz crystal.
+  MSP430_MCLK_HZ, MSP430_SMCLK_HZ and MSP430_ACLK_HZ are derived from them
+  and fold to literals, so they can be used in #if and MSP430_STATIC_ASSERT
+  as well as in peripheral settings. MSP430_BCS_* take the BCS_CTL1_DIVA_x,
+  BCS_CTL2_SELM_x, BCS_CTL2_DIVM_x, BCS_CTL2_DIVS_x and BCS_CTL3_LFXT1S_x
+  values; MSP430_BCS_SELS is 0 for DCOCLK and 1 for LFXT1CLK/VLOCLK. */
+
+#ifndef MSP430_DCOCLK_HZ
+#define MSP430_DCOCLK_HZ (1000000UL) /* DCOCLK frequency */
+#endif
+#ifndef MSP430_LFXT1CLK_HZ
+#define MSP430_LFXT1CLK_HZ (32768UL) /* LFXT1 crystal or external clock frequency */
+#endif
+#ifndef MSP430_VLOCLK_HZ
+#define MSP430_VLOCLK_HZ (12000UL) /* VLOCLK frequency, typical */
+#endif
+#define MSP430_VLOCLK_MIN_HZ (4000UL)  /* VLOCLK frequency, minimum */
+#define MSP430_VLOCLK_MAX_HZ (20000UL) /* VLOCLK frequency, maximum */
+#ifndef MSP430_BCS_LFXT1S
+#define MSP430_BCS_LFXT1S BCS_CTL3_LFXT1S_32K_CRYSTAL
+#endif
+#ifndef MSP430_BCS_SELM
+#define MSP430_BCS_SELM BCS_CTL2_SELM_DCOCLK
+#endif
+#ifndef MSP430_BCS_DIVM
+#define MSP430_BCS_DIVM BCS_CTL2_DIVM_1
+#endif
+#ifndef MSP430_BCS_SELS
+#define MSP430_BCS_SELS (0U)
+#endif
+#ifndef MSP430_BCS_DIVS
+#define MSP430_BCS_DIVS BCS_CTL2_DIVS_1
+#endif
+#ifndef MSP430_BCS_DIVA
+#define MSP430_BCS_DIVA BCS_CTL1_DIVA_1
+#endif
+
+/* LFXT1CLK or VLOCLK, whichever LFXT1S selects */
+#define MSP430_LFCLK_HZ  ((MSP430_BCS_LFXT1S == BCS_CTL3_LFXT1S_VLOCLK) ? MSP430_VLOCLK_HZ : MSP430_LFXT1CLK_HZ)
+#define MSP430_MCLK_HZ   (((MSP430_BCS_SELM >= BCS_CTL2_SELM_XT2CLK_LFXT1CLK) ? MSP430_LFCLK_HZ : MSP430_DCOCLK_HZ) >> MSP430_BCS_DIVM)
+#define MSP430_SMCLK_HZ  (((MSP430_BCS_SELS != 0U) ? MSP430_LFCLK_HZ : MSP430_DCOCLK_HZ) >> MSP430_BCS_DIVS)
+#define MSP430_ACLK_HZ   (MSP430_LFCLK_HZ >> MSP430_BCS_DIVA)
+
+/* Register values matching the configuration above */
+#define MSP430_BCS_CTL2_VALUE \
+  (BCS_CTL2_SELM(MSP430_BCS_SELM) | BCS_CTL2_DIVM(MSP430_BCS_DIVM) | BCS_CTL2_SELS(MSP430_BCS_SELS) | BCS_CTL2_DIVS(MSP430_BCS_DIVS))
+#define MSP430_BCS_CTL1_DIVA_VALUE BCS_CTL1_DIVA(MSP430_BCS_DIVA)
+#define MSP430_BCS_CTL3_LFXT1S_VALUE BCS_CTL3_LFXT1S(MSP430_BCS_LFXT1S)
+
+#if (MSP430_DCOCLK_HZ > 16000000UL)
+#error "MSP430_DCOCLK_HZ exceeds 16 MHz"
+#endif
+#if (MSP430_MCLK_HZ > 16000000UL)
+#error "MCLK exceeds 16 MHz"
+#endif
+#if (MSP430_SMCLK_HZ > 16000000UL)
+#error "SMCLK exceeds 16 MHz"
+#endif
+#if (MSP430_BCS_LFXT1S == BCS_CTL3_LFXT1S_RESERVED)
+#error "MSP430_BCS_LFXT1S selects a reserved setting"
+#endif
+#if (MSP430_BCS_LFXT1S == BCS_CTL3_LFXT1S_32K_CRYSTAL) && (MSP430_LFXT1CLK_HZ != 32768UL)
+#error "LFXT1 in low-frequency crystal mode expects a 32768 Hz crystal"
+#endif
+
+/* Non-zero when the TLV_BCS_CLK_x calibration entry is programmed (not erased) */
+#define TLV_BCS_CAL_VALID(idx) (TLV->CAL_BCS[idx].BCSCTL1 != 0xffU)
+
+/* Hook run by BCS_SET_CALIBRATED_DCO after the switch, with the new DCO
+  frequency in Hz. Define it before including this header to retune
+  peripherals (UART baud, timer periods, flash divider) to the new clock. */
+#ifndef MSP430_DCO_CHANGE_HOOK
+#define MSP430_DCO_CHANGE_HOOK(hz) ((void)0)
+#endif
+
+/* BCS_SET_CALIBRATED_DCO */
+/* Switches the DCO to the TLV_BCS_CLK_x calibration entry idx at run time.
+  DCOCTL is cleared first so the DCO sits on its lowest tap while RSEL
+  changes and cannot overshoot the target, in either direction; only
+  RSEL is taken from the calibration byte so DIVA, XTS and XT2OFF are
+  kept. The switch itself takes three byte writes.
+  Check TLV_BCS_CAL_VALID(idx) first, and make sure VCC allows the
+  target frequency before switching up. */
+#define BCS_SET_CALIBRATED_DCO(idx)                                                                               \
+  do                                                                                                              \
+  {                                                                                                               \
+    BCS->DCOCTL = 0U;                                                                                             \
+    BCS->CTL1   = (uint8_t)((BCS->CTL1 & ~BCS_CTL1_RSEL_MASK) | (TLV->CAL_BCS[idx].BCSCTL1 & BCS_CTL1_RSEL_MASK)); \
+    BCS->DCOCTL = TLV->CAL_BCS[idx].DCOCTL;                                                                       \
+    MSP430_DCO_CHANGE_HOOK(TLV_BCS_CLK_HZ(idx));                                                                  \
+  } while (0)
+
+/* Software FLL.
+  ACLK is internally connected to the CCI0B capture input of Timer0_A.
+  With TA0 running continuously from SMCLK = DCOCLK and CCTL[0] set to
+  TA_CCTL_CAPTURE_ACLK, the difference between two captures is the number
+  of DCO clocks per ACLK period. BCS_FLL_DELTA gives the expected count
+  for a target frequency; dividing ACLK (DIVA) lengthens the gate time
+  and improves the resolution, e.g. 7.3728 MHz is exactly 1800 clocks of
+  ACLK / 8 from a 32768 Hz crystal, and the 16 MHz device maximum rounds
+  to 3906 clocks (0.01 % low). Stay at or below 16 MHz. Each
+  BCS_FLL_STEP moves the DCO by one modulator step (about 0.2 %) towards
+  the target, so a capture ISR enabled now and then keeps the DCO locked
+  over temperature at a few instructions per correction. */
+#define TA_CCTL_CAPTURE_ACLK \
+  (TA_CCTL_CM(TA_CCTL_CM_RISING) | TA_CCTL_CCIS(TA_CCTL_CCIS_CCIXB) | TA_CCTL_SCS(1U) | TA_CCTL_CAP(1U))
+
+/* DCO clocks expected per ACLK period (ACLK after DIVA) for fdco Hz */
+#define BCS_FLL_DELTA(fdco, faclk) (((fdco) + ((faclk) / 2UL)) / (faclk))
+
+/* Highest usable DCOCTL value: DCO = 7 with MOD = 0, MOD is not usable at DCO = 7 */
+#define BCS_DCOCTL_MAX (BCS_DCOCTL_DCO(7U))
+
+/* BCS_FLL_STEP */
+/* One FLL correction from a measured capture delta. At the end of a range
+  RSEL moves by one and DCO is reloaded near the same frequency (DCO = 3
+  going up, DCO = 4 going down), as one RSEL step is roughly four DCO
+  steps. */
+#define BCS_FLL_STEP(delta, target)                                                          \
+  do                                                                                         \
+  {                                                                                          \
+    uint8_t bcs_dco_  = BCS->DCOCTL;                                                         \
+    uint8_t bcs_rsel_ = (uint8_t)(BCS->CTL1 & BCS_CTL1_RSEL_MASK);                           \
+    if ((delta) < (target))                                                                  \
+    {                                                                                        \
+      if (bcs_dco_ < BCS_DCOCTL_MAX)                                                         \
+      {                                                                                      \
+        BCS->DCOCTL = (uint8_t)(bcs_dco_ + 1U);                                              \
+      }                                                                                      \
+      else if (bcs_rsel_ < BCS_CTL1_RSEL_MASK)                                               \
+      {                                                                                      \
+        BCS->DCOCTL = BCS_DCOCTL_DCO(3U);                                                    \
+        BCS->CTL1   = (uint8_t)((BCS->CTL1 & ~BCS_CTL1_RSEL_MASK) | (bcs_rsel_ + 1U));       \
+      }                                                                                      \
+    }                                                                                        \
+    else if ((delta) > (target))                                                             \
+    {                                                                                        \
+      if (bcs_dco_ != 0U)                                                                    \
+      {                                                                                      \
+        BCS->DCOCTL = (uint8_t)(bcs_dco_ - 1U);                                              \
+      }                                                                                      \
+      else if (bcs_rsel_ != 0U)                                                              \
+      {                                                                                      \
+        BCS->CTL1   = (uint8_t)((BCS->CTL1 & ~BCS_CTL1_RSEL_MASK) | (bcs_rsel_ - 1U));       \
+        BCS->DCOCTL = BCS_DCOCTL_DCO(4U);                                                    \
+      }                                                                                      \
+    }                                                                                        \
+  } while (0)
+
+/* LFXT1 oscillator fault handling.
+  A stalled crystal sets LFXT1OF and IFG1_OFIFG; with IE1_OFIE set this
+  enters the NMI vector, which clears OFIE on entry. BCS_LFXT1_TO_VLO moves
+  ACLK to VLOCLK right away so ACLK timers keep running. The VLO is only
+  known to within MSP430_VLOCLK_MIN_HZ..MSP430_VLOCLK_MAX_HZ, so measure
+  it with TA_CCTL_CAPTURE_ACLK (ACLK undivided) and rescale the timer
+  periods with BCS_VLO_SCALE_Q16 and TA_TICKS_SCALE_Q16. Retry the crystal
+  later with BCS_LFXT1_TO_CRYSTAL, which restores the configured
+  MSP430_BCS_LFXT1S source: once BCS_LFXT1_FAULT stays clear after OFIFG
+  is cleared, restore the original periods and re-enable OFIE. */
+#define BCS_LFXT1_FAULT ((BCS->CTL3 & BCS_CTL3_LFXT1OF_MASK) != 0U)
+
+#define BCS_LFXT1_TO_VLO()                                                                                     \
+  do                                                                                                           \
+  {                                                                                                            \
+    BCS->CTL3 = (uint8_t)((BCS->CTL3 & ~BCS_CTL3_LFXT1S_MASK) | BCS_CTL3_LFXT1S(BCS_CTL3_LFXT1S_VLOCLK));      \
+    SFR->IFG1 &= (uint8_t)~IFG1_OFIFG_MASK;                                                                    \
+  } while (0)
+
+#define BCS_LFXT1_TO_CRYSTAL()                                                                                 \
+  do                                                                                                           \
+  {                                                                                                            \
+    BCS->CTL3 = (uint8_t)((BCS->CTL3 & ~BCS_CTL3_LFXT1S_MASK) | MSP430_BCS_CTL3_LFXT1S_VALUE);                 \
+    SFR->IFG1 &= (uint8_t)~IFG1_OFIFG_MASK;                                                                    \
+  } while (0)
+
+/* 0.16 fixed point ratio VLOCLK / 32768 Hz from delta, the number of
+  fclk Hz timer clocks per VLOCLK period. Computed once per fault. */
+#define BCS_VLO_SCALE_Q16(delta, fclk) ((uint16_t)((2UL * (fclk)) / (uint16_t)(delta)))
+
+/* ticks scaled by a 0.16 fixed point ratio, rounded to nearest */
+#define TA_TICKS_SCALE_Q16(ticks, scale) \
+  ((uint16_t)((((uint32_t)(uint16_t)(ticks) * (uint16_t)(scale)) + 0x8000UL) >> 16))
+
 /*****************************************************************************
 * @brief CA_CTL1
 *****************************************************************************/
@@ -1428,6 +1921,20 @@ typedef struct
 #define FLASH_CTL2_FSSEL_SMCLK  (2U) /* Flash controller clock source select: SMCLK */
 #define FLASH_CTL2_FSSEL_SMCLK2 (3U) /* Flash controller clock source select: SMCLK */
 
+/* Flash timing generator frequency limits */
+#define FLASH_FTG_MIN_HZ (257000UL) /* Minimum fFTG */
+#define FLASH_FTG_MAX_HZ (476000UL) /* Maximum fFTG */
+
+/* FLASH_CTL2_FN_FOR */
+/* Smallest FN divider bringing a flash controller clock of fclk Hz down to
+  FLASH_FTG_MAX_HZ or below. Check the source with FLASH_FTG_IN_RANGE. */
+#define FLASH_CTL2_FN_FOR(fclk) ((((fclk) + FLASH_FTG_MAX_HZ - 1UL) / FLASH_FTG_MAX_HZ) - 1UL)
+
+/* FLASH_FTG_IN_RANGE */
+/* Non-zero when fclk Hz can be divided into the fFTG range by FN */
+#define FLASH_FTG_IN_RANGE(fclk) \
+  ((FLASH_CTL2_FN_FOR(fclk) <= 63UL) && (((fclk) / (FLASH_CTL2_FN_FOR(fclk) + 1UL)) >= FLASH_FTG_MIN_HZ))
+
 /*****************************************************************************
 * @brief FLASH_CTL3
 *****************************************************************************/
@@ -1531,7 +2038,7 @@ typedef struct
 #define TA_CTL_TASSEL(x)    (((uint16_t)(((uint16_t)(x)) << TA_CTL_TASSEL_SHIFT)) & TA_CTL_TASSEL_MASK)
 
 /* TA_CTL_ID */
-#define TA_CTL_ID_MASK  (0x30U)
+#define TA_CTL_ID_MASK  (0xc0U)
 #define TA_CTL_ID_SHIFT (0x6U)
 /* Input divider. These bits select the divider for the input clock.
   00b = /1
@@ -1589,6 +2096,45 @@ typedef struct
 #define TA_CTL_TASSEL_SMCLK (2U) /* Timer A clock source select: SMCLK */
 #define TA_CTL_TASSEL_INCLK (3U) /* Timer A clock source select: INCLK */
 
+/* TA_CTL_ID_FOR */
+/* Smallest input divider (TA_CTL_ID_x value) for which one period of
+  rate Hz fits the 16-bit up-mode counter clocked at fclk Hz. Uses the
+  rounded tick count of TA_PERIOD_TICKS, so CCR0 never wraps to 0. */
+#define TA_CTL_ID_FOR(fclk, rate) \
+  ((TA_PERIOD_TICKS(fclk, TA_CTL_ID_1, rate) <= 65536UL) ? TA_CTL_ID_1 : \
+   (TA_PERIOD_TICKS(fclk, TA_CTL_ID_2, rate) <= 65536UL) ? TA_CTL_ID_2 : \
+   (TA_PERIOD_TICKS(fclk, TA_CTL_ID_4, rate) <= 65536UL) ? TA_CTL_ID_4 : TA_CTL_ID_8)
+
+/* TA_PERIOD_TICKS */
+/* Timer clocks per period of rate Hz with input divider id, rounded to nearest */
+#define TA_PERIOD_TICKS(fclk, id, rate) ((((fclk) >> (id)) + (rate) / 2UL) / (rate))
+
+/* TA_CCR0_FOR */
+/* Up-mode CCR0 value giving rate Hz, with the divider from TA_CTL_ID_FOR */
+#define TA_CCR0_FOR(fclk, rate) \
+  ((uint16_t)(TA_PERIOD_TICKS(fclk, TA_CTL_ID_FOR(fclk, rate), rate) - 1UL))
+
+/* TA_RATE_IN_RANGE */
+/* Non-zero when rate Hz can be generated from fclk Hz at all: at least
+  two timer clocks per period and no more than 65536 after /8, counted
+  as TA_PERIOD_TICKS rounds them */
+#define TA_RATE_IN_RANGE(fclk, rate) \
+  ((TA_PERIOD_TICKS(fclk, TA_CTL_ID_1, rate) >= 2UL) && (TA_PERIOD_TICKS(fclk, TA_CTL_ID_8, rate) <= 65536UL))
+
+/* TA_RATE_ERROR_PPM */
+/* Error of the rate achieved with TA_CCR0_FOR against rate, in ppm.
+  Positive when the timer runs faster than requested. */
+#define TA_RATE_ERROR_PPM(fclk, rate) \
+  ((int32_t)((int64_t)((fclk) >> TA_CTL_ID_FOR(fclk, rate)) * 1000000 / \
+   (int64_t)(TA_PERIOD_TICKS(fclk, TA_CTL_ID_FOR(fclk, rate), rate) * (rate)) - 1000000))
+
+/* TA_CTL_UP_RATE */
+/* TA_CTL value running the timer in up mode from clock source tassel
+  (TA_CTL_TASSEL_x value, clocked at fclk Hz) for a period of rate Hz.
+  Load CCR0 with TA_CCR0_FOR(fclk, rate) before writing TA_CTL. */
+#define TA_CTL_UP_RATE(tassel, fclk, rate) \
+  (TA_CTL_TASSEL(tassel) | TA_CTL_ID(TA_CTL_ID_FOR(fclk, rate)) | TA_CTL_MC(TA_CTL_MC_UPTOCCR0) | TA_CTL_TACLR(1U))
+
 /*****************************************************************************
 * @brief TA_CCTL
 *****************************************************************************/
@@ -1861,6 +2407,183 @@ is latched with the EQUx signal and can be read via this bit */
 #define USCI_UART_CTL1_UCSSEL_SMCLK  (2U) /* USCI clock source select: SMCLK */
 #define USCI_UART_CTL1_UCSSEL_SMCLK2 (3U) /* USCI clock source select: SMCLK */
 
+/* Interrupt-driven UCA0 UART.
+  RX: the USCIAB0RX_VECTOR handler stores RXBUF at RING_SLOT(head) of the
+  RX ring and advances head; the main loop drains it through tail.
+  TX: the main loop stores a byte at RING_SLOT(head) of the TX ring,
+  advances head and only then calls USCI_UART_TX_KICK. UCA0TXIFG stays set
+  while TXBUF is empty, so enabling UCA0TXIE enters USCIAB0TX_VECTOR right
+  away; the handler writes the next byte to TXBUF, or clears UCA0TXIE once
+  the ring is empty. Both IE2 updates are single BIS.B/BIC.B instructions,
+  so neither side disables interrupts and the CPU can sleep in LPM0
+  between bytes. */
+#define USCI_UART_TX_KICK()  (SFR->IE2 |= IE2_UCA0TXIE_MASK)
+#define USCI_UART_TX_IDLE()  (SFR->IE2 &= (uint8_t)~IE2_UCA0TXIE_MASK)
+
+/* CPU clocks available per character at fclk Hz and baud bit/s with
+  10-bit frames (start, 8 data, stop): the upper bound for the RX plus TX
+  handler cost at full duplex */
+#define USCI_UART_CYCLES_PER_CHAR(fclk, baud) (((fclk) * 10UL) / (baud))
+
+/* Ring handlers. ring is a uint8_t array of n bytes (RING_IS_POW2), head
+  and tail are its volatile uint8_t RING_* counters. USCI_UART_RX_IRQ runs
+  in USCIAB0RX_VECTOR: it always reads RXBUF, and when the ring is full,
+  or UCOE shows the USCI already lost a character, it counts the loss in
+  the caller's dropped counter instead of blocking; the byte that found
+  the ring full is discarded. USCI_UART_TX_IRQ runs in USCIAB0TX_VECTOR
+  and sends the byte at tail, or goes idle. USCI_UART_PUT and
+  USCI_UART_GET are the main loop side; ok reports whether a byte was
+  queued or taken.
+  Cycle costs of the handler bodies below are counted from the MSP430
+  instruction timings for head, tail and dropped in RAM with absolute
+  addressing; check them against the compiler listing. Entry adds
+  USCI_UART_IRQ_ENTRY_CYCLES per interrupt (6 for acceptance, 5 for RETI,
+  20 to save and restore four registers) and USCI_DISPATCH_CYCLES when
+  the vector is shared through USCI_DISPATCH. USCI_UART_DUPLEX_CYCLES
+  must stay below USCI_UART_CYCLES_PER_CHAR: at 8 MHz and 115200 baud
+  it is 116 of 694 cycles. */
+#define USCI_UART_RX_IRQ_CYCLES    (33U) /* Byte stored, no overrun */
+#define USCI_UART_TX_IRQ_CYCLES    (21U) /* Byte sent */
+#define USCI_UART_IRQ_ENTRY_CYCLES (31U)
+#define USCI_UART_DUPLEX_CYCLES    (USCI_UART_RX_IRQ_CYCLES + USCI_UART_TX_IRQ_CYCLES + 2U * USCI_UART_IRQ_ENTRY_CYCLES)
+
+#define USCI_UART_RX_IRQ(ring, head, tail, n, dropped)                                                    \
+  do {                                                                                                    \
+    uint8_t c_;                                                                                           \
+    if ((UCA0_UART->STAT & USCI_UART_STAT_UCOE_MASK) != 0U) {                                             \
+      (dropped)++;                                                                                        \
+    }                                                                                                     \
+    c_ = UCA0_UART->RXBUF;                                                                                \
+    if (RING_FULL(head, tail, n)) {                                                                       \
+      (dropped)++;                                                                                        \
+      break;                                                                                              \
+    }                                                                                                     \
+    (ring)[RING_SLOT(head, n)] = c_;                                                                      \
+    (head)++;                                                                                             \
+  } while (0)
+
+#define USCI_UART_TX_IRQ(ring, head, tail, n)                                                             \
+  do {                                                                                                    \
+    if (RING_EMPTY(head, tail)) {                                                                         \
+      USCI_UART_TX_IDLE();                                                                                \
+      break;                                                                                              \
+    }                                                                                                     \
+    UCA0_UART->TXBUF = (ring)[RING_SLOT(tail, n)];                                                        \
+    (tail)++;                                                                                             \
+  } while (0)
+
+#define USCI_UART_PUT(ring, head, tail, n, c, ok)                                                         \
+  do {                                                                                                    \
+    (ok) = !RING_FULL(head, tail, n);                                                                     \
+    if (ok) {                                                                                             \
+      (ring)[RING_SLOT(head, n)] = (uint8_t)(c);                                                          \
+      (head)++;                                                                                           \
+      USCI_UART_TX_KICK();                                                                                \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_UART_GET(ring, head, tail, n, c, ok)                                                         \
+  do {                                                                                                    \
+    (ok) = !RING_EMPTY(head, tail);                                                                       \
+    if (ok) {                                                                                             \
+      (c) = (ring)[RING_SLOT(tail, n)];                                                                   \
+      (tail)++;                                                                                           \
+    }                                                                                                     \
+  } while (0)
+
+/* Receiver and transmitter multiprocessor controls on UCA0CTL1.
+  USCI_UART_TX_MARK makes the next character written to TXBUF an address
+  character in address-bit mode, or precedes it with an idle period of
+  11 bit times in idle-line mode. With USCI_UART_RX_DORMANT only address
+  (or first-after-idle) characters set UCA0RXIFG, and without UCRXEIE
+  characters with framing or parity errors do not wake the CPU at all. */
+#define USCI_UART_TX_MARK()    (UCA0_UART->CTL1 |= USCI_UART_CTL1_UCTXADDR_MASK)
+#define USCI_UART_RX_DORMANT() (UCA0_UART->CTL1 |= USCI_UART_CTL1_UCDORM_MASK)
+#define USCI_UART_RX_AWAKE()   (UCA0_UART->CTL1 &= (uint8_t)~USCI_UART_CTL1_UCDORM_MASK)
+
+/* Idle-line framed receive.
+  UCA0CTL0 is set up with USCI_UART_CTL0_UCMODE(USCI_UART_CTL0_UCMODE_IDLE_LINE)
+  and the receiver starts dormant. Each frame is sent as an idle period
+  (USCI_UART_TX_MARK before the first byte), a payload length byte and
+  the payload. The length byte is the only character the receiver sees
+  while dormant; it reopens the receiver for exactly that many bytes and
+  the frame is committed on the last one, after which the receiver goes
+  dormant again. A new idle-marked character always starts a new frame,
+  so a frame cut short by noise is overwritten rather than merged into
+  the next one.
+  The frame pool is n slots (RING_IS_POW2) of size bytes each; slot[0]
+  holds the length, so payloads up to size - 1 bytes fit. head and tail
+  are the RING_* counters over the pool and fill is the write position
+  in the open slot. The USCIAB0RX_VECTOR handler reads UCA0STAT before
+  UCA0RXBUF (reading RXBUF clears UCIDLE) and passes both to
+  USCI_UART_FRAME_RX. Frames that do not fit or arrive while the pool is
+  full are dropped and the receiver stays dormant through them. The main
+  loop reads the frame at RING_SLOT(tail, n) in place through
+  USCI_UART_FRAME_DATA and USCI_UART_FRAME_LEN and then advances tail. */
+#define USCI_UART_STAT_UCIDLE_MASK USCI_UART_STAT_UCADDR_MASK
+
+#define USCI_UART_FRAME_RX(pool, fill, head, tail, n, size, stat, c)          \
+  do {                                                                        \
+    uint8_t *frame_ = (pool)[RING_SLOT(head, n)];                             \
+    if (((stat) & USCI_UART_STAT_UCIDLE_MASK) != 0U) {                        \
+      if (RING_FULL(head, tail, n) || ((uint8_t)(c) >= (uint8_t)(size))) {    \
+        USCI_UART_RX_DORMANT();                                               \
+        break;                                                                \
+      }                                                                       \
+      (fill) = 0U;                                                            \
+      USCI_UART_RX_AWAKE();                                                   \
+    }                                                                         \
+    frame_[(fill)++] = (uint8_t)(c);                                          \
+    if ((fill) > frame_[0]) {                                                 \
+      (head)++;                                                               \
+      USCI_UART_RX_DORMANT();                                                 \
+    }                                                                         \
+  } while (0)
+
+#define USCI_UART_FRAME_DATA(pool, slot) (&(pool)[slot][1]) /* Payload of a committed frame */
+#define USCI_UART_FRAME_LEN(pool, slot)  ((pool)[slot][0])  /* Payload length of a committed frame */
+
+/* Address-bit multidrop receive.
+  UCA0CTL0 is set up with USCI_UART_CTL0_UCMODE(USCI_UART_CTL0_UCMODE_ADDRESS_BIT)
+  and the receiver starts dormant. A frame is an address character
+  (USCI_UART_TX_MARK immediately before it is written to TXBUF; UCTXADDR
+  clears itself once the character is loaded), a payload length byte and
+  the payload. While dormant the USCI sets UCA0RXIFG only for address
+  characters, so a node takes one interrupt per frame on the bus and
+  2 + length interrupts for frames sent to its own address or to
+  USCI_UART_ADDR_BROADCAST. USCI_UART_ADDR_RX is called from the
+  USCIAB0RX_VECTOR handler with UCA0STAT read before UCA0RXBUF and uses
+  the same frame pool as USCI_UART_FRAME_RX; committed frames are read
+  with USCI_UART_FRAME_DATA and USCI_UART_FRAME_LEN. */
+#ifndef USCI_UART_ADDR_BROADCAST
+#define USCI_UART_ADDR_BROADCAST (0xffU) /* Address accepted by every node */
+#endif
+
+#define USCI_UART_ADDR_MATCH(c, own) (((uint8_t)(c) == (uint8_t)(own)) || ((uint8_t)(c) == USCI_UART_ADDR_BROADCAST))
+
+#define USCI_UART_ADDR_RX(pool, fill, head, tail, n, size, own, stat, c)     \
+  do {                                                                        \
+    uint8_t *frame_ = (pool)[RING_SLOT(head, n)];                             \
+    if (((stat) & USCI_UART_STAT_UCADDR_MASK) != 0U) {                        \
+      if (!USCI_UART_ADDR_MATCH(c, own) || RING_FULL(head, tail, n)) {        \
+        USCI_UART_RX_DORMANT();                                               \
+      } else {                                                                \
+        (fill) = 0U;                                                          \
+        USCI_UART_RX_AWAKE();                                                 \
+      }                                                                       \
+      break;                                                                  \
+    }                                                                         \
+    if (((fill) == 0U) && ((uint8_t)(c) >= (uint8_t)(size))) {                \
+      USCI_UART_RX_DORMANT();                                                 \
+      break;                                                                  \
+    }                                                                         \
+    frame_[(fill)++] = (uint8_t)(c);                                          \
+    if ((fill) > frame_[0]) {                                                 \
+      (head)++;                                                               \
+      USCI_UART_RX_DORMANT();                                                 \
+    }                                                                         \
+  } while (0)
+
 /*****************************************************************************
 * @brief USCI_UART_MCTL
 *****************************************************************************/
@@ -1889,6 +2612,71 @@ is latched with the EQUx signal and can be read via this bit */
   1b = Enabled */
 #define USCI_UART_MCTL_UCOS16(x)    (((uint8_t)(((uint8_t)(x)) << USCI_UART_MCTL_UCOS16_SHIFT)) & USCI_UART_MCTL_UCOS16_MASK)
 
+/* Compile-time baud-rate generator.
+  For a BRCLK of brclk Hz (the clock selected with USCI_UART_CTL1_UCSSEL)
+  and a target of baud bit/s, USCI_UART_BR0_FOR, USCI_UART_BR1_FOR and
+  USCI_UART_MCTL_FOR give the three register values, so the setup is three
+  byte stores of constants. Both low-frequency mode (UCBRx + UCBRSx / 8)
+  and oversampling mode (16 * UCBRx + UCBRFx, needs brclk >= 16 * baud)
+  are evaluated and the one with the lower estimated worst-case bit error
+  is used. The estimate is the rate error accumulated over a 10-bit frame
+  plus half a BRCLK of modulation jitter, in ppm of a bit time. */
+#ifndef USCI_UART_MAX_BIT_ERROR_PPM
+#define USCI_UART_MAX_BIT_ERROR_PPM (300000L) /* Accepted worst-case bit error, 30 % by default */
+#endif
+
+#define USCI_UART_ABS_(x) (((x) < 0) ? -(x) : (x))
+
+/* Low-frequency mode: BRCLK per bit in eighths */
+#define USCI_UART_LF_BR_(brclk, baud)   ((brclk) / (baud))
+#define USCI_UART_LF_BRS0_(brclk, baud) (((((brclk) - (USCI_UART_LF_BR_(brclk, baud) * (baud))) * 16UL) + (baud)) / (2UL * (baud)))
+#define USCI_UART_LF_BRS_(brclk, baud)  ((USCI_UART_LF_BRS0_(brclk, baud) > 7UL) ? 7UL : USCI_UART_LF_BRS0_(brclk, baud))
+#define USCI_UART_LF_DIV8_(brclk, baud) ((USCI_UART_LF_BR_(brclk, baud) * 8UL) + USCI_UART_LF_BRS_(brclk, baud))
+#define USCI_UART_LF_ERR_(brclk, baud) \
+  (((int64_t)(brclk) * 8000000 / ((int64_t)USCI_UART_LF_DIV8_(brclk, baud) * (int64_t)(baud))) - 1000000)
+
+/* Oversampling mode: BRCLK per bit */
+#define USCI_UART_OS_BR_(brclk, baud)   ((brclk) / (16UL * (baud)))
+#define USCI_UART_OS_BRF0_(brclk, baud) (((((brclk) - (USCI_UART_OS_BR_(brclk, baud) * 16UL * (baud))) * 2UL) + (baud)) / (2UL * (baud)))
+#define USCI_UART_OS_BRF_(brclk, baud)  ((USCI_UART_OS_BRF0_(brclk, baud) > 15UL) ? 15UL : USCI_UART_OS_BRF0_(brclk, baud))
+#define USCI_UART_OS_DIV_(brclk, baud)  ((USCI_UART_OS_BR_(brclk, baud) * 16UL) + USCI_UART_OS_BRF_(brclk, baud))
+#define USCI_UART_OS_ERR_(brclk, baud) \
+  (((int64_t)(brclk) * 1000000 / ((int64_t)USCI_UART_OS_DIV_(brclk, baud) * (int64_t)(baud))) - 1000000)
+
+#define USCI_UART_WORST_(err, brclk, baud) ((10 * USCI_UART_ABS_(err)) + ((int64_t)(baud) * 500000 / (int64_t)(brclk)))
+
+/* Non-zero when oversampling mode is selected */
+#define USCI_UART_OS16_FOR(brclk, baud)             \
+  (((brclk) >= (16UL * (baud))) &&                  \
+   (USCI_UART_WORST_(USCI_UART_OS_ERR_(brclk, baud), brclk, baud) <= USCI_UART_WORST_(USCI_UART_LF_ERR_(brclk, baud), brclk, baud)))
+
+/* 16-bit UCBRx prescaler */
+#define USCI_UART_BR_FOR(brclk, baud) \
+  ((uint16_t)(USCI_UART_OS16_FOR(brclk, baud) ? USCI_UART_OS_BR_(brclk, baud) : USCI_UART_LF_BR_(brclk, baud)))
+
+#define USCI_UART_BR0_FOR(brclk, baud) ((uint8_t)(USCI_UART_BR_FOR(brclk, baud) & 0xffU))
+#define USCI_UART_BR1_FOR(brclk, baud) ((uint8_t)(USCI_UART_BR_FOR(brclk, baud) >> 8))
+
+#define USCI_UART_MCTL_FOR(brclk, baud)                                                                     \
+  ((uint8_t)(USCI_UART_OS16_FOR(brclk, baud) ?                                                              \
+     (USCI_UART_MCTL_UCBRF0(USCI_UART_OS_BRF_(brclk, baud)) | USCI_UART_MCTL_UCOS16(1U)) :                  \
+     USCI_UART_MCTL_UCBRS0(USCI_UART_LF_BRS_(brclk, baud))))
+
+/* Mean baud-rate error in ppm, positive when faster than baud */
+#define USCI_UART_BAUD_ERROR_PPM(brclk, baud) \
+  ((int32_t)(USCI_UART_OS16_FOR(brclk, baud) ? USCI_UART_OS_ERR_(brclk, baud) : USCI_UART_LF_ERR_(brclk, baud)))
+
+/* Estimated worst-case bit error in ppm of a bit time */
+#define USCI_UART_BIT_ERROR_PPM(brclk, baud)                                                       \
+  ((int32_t)(USCI_UART_OS16_FOR(brclk, baud) ? USCI_UART_WORST_(USCI_UART_OS_ERR_(brclk, baud), brclk, baud) : \
+                                               USCI_UART_WORST_(USCI_UART_LF_ERR_(brclk, baud), brclk, baud)))
+
+/* Fails the build when baud cannot be generated from brclk accurately enough */
+#define USCI_UART_BAUD_ASSERT(brclk, baud)                                                            \
+  MSP430_STATIC_ASSERT(((brclk) >= (baud)) && (USCI_UART_BR_FOR(brclk, baud) != 0U) &&                \
+                       (USCI_UART_BIT_ERROR_PPM(brclk, baud) <= USCI_UART_MAX_BIT_ERROR_PPM),       \
+                       "UART baud rate error too large")
+
 /*****************************************************************************
 * @brief USCI_UART_STAT
 *****************************************************************************/
@@ -2059,6 +2847,131 @@ by: tMIN = (UCIRRXFLx + 4) / (2 ? fBRCLK) */
   measured and baud rate settings are changed accordingly. */
 #define USCI_UART_ABCTL_UCABDEN(x)    (((uint8_t)(((uint8_t)(x)) << USCI_UART_ABCTL_UCABDEN_SHIFT)) & USCI_UART_ABCTL_UCABDEN_MASK)
 
+#define USCI_UART_ABCTL_UCDELIM_1BIT (0U) /* Break and synch delimiter length: 1 bit time */
+#define USCI_UART_ABCTL_UCDELIM_2BIT (1U) /* Break and synch delimiter length: 2 bit times */
+#define USCI_UART_ABCTL_UCDELIM_3BIT (2U) /* Break and synch delimiter length: 3 bit times */
+#define USCI_UART_ABCTL_UCDELIM_4BIT (3U) /* Break and synch delimiter length: 4 bit times */
+
+/* LIN slave on UCA0.
+  UCA0CTL0 is set up with USCI_UART_CTL0_UCMODE(USCI_UART_CTL0_UCMODE_UART_AUTO),
+  UCA0ABCTL with USCI_UART_ABCTL_LIN and UCA0CTL1 with UCBRKIE and UCDORM.
+  The USCI measures the break and synch field and reloads UCA0BR0/BR1 and
+  UCA0MCTL itself, so the DCO only has to stay within the LIN clock
+  tolerance over one frame, not be trimmed to the master. While dormant
+  only a complete break/synch sets UCA0RXIFG, so bus traffic between
+  headers costs no interrupts. The USCIAB0RX_VECTOR handler reads
+  UCA0STAT before UCA0RXBUF and passes both to LIN_SLAVE_RX, which runs:
+  1. UCBRK set: the synch byte is discarded. If USCI_UART_ABCTL_LIN_ERROR,
+     clear the flags and stay dormant; otherwise USCI_UART_RX_AWAKE and
+     expect the PID. A break always restarts the frame.
+  2. PID: drop the frame unless LIN_PID_VALID. Set SUM = LIN_CSUM_INIT(pid)
+     and LEN = LIN_ID_LENGTH, then call LOOKUP, which may change LEN and
+     returns LIN_SLAVE_IGNORE, LIN_SLAVE_SUBSCRIBE or LIN_SLAVE_PUBLISH
+     (after filling DATA). A publisher writes DATA[0] to TXBUF right away.
+  3. Each following byte, the master's or the node's own echo on the
+     single-wire bus, goes through LIN_CSUM_ADD; a published byte that
+     reads back differently is a bit error and ends the response. After
+     the last data byte the publisher sends LIN_CSUM_FINAL(sum) and a
+     subscriber compares it with the checksum byte and calls DONE. Then
+     USCI_UART_RX_DORMANT.
+  Every step is a constant amount of work per byte, so the response
+  starts one handler run after the PID stop bit, far inside the response
+  space; LIN_FRAME_MAX_US gives the slot a frame must fit in. */
+#define USCI_UART_ABCTL_LIN       (USCI_UART_ABCTL_UCABDEN(1U) | USCI_UART_ABCTL_UCDELIM(USCI_UART_ABCTL_UCDELIM_1BIT))
+#define USCI_UART_ABCTL_ERR_MASK  (USCI_UART_ABCTL_UCBTOE_MASK | USCI_UART_ABCTL_UCSTOE_MASK)
+#define USCI_UART_ABCTL_LIN_ERROR ((UCA0_UART->ABCTL & USCI_UART_ABCTL_ERR_MASK) != 0U)
+
+#define LIN_ID_MASK    (0x3fU)
+#define LIN_PID_ID(pid) ((uint8_t)((pid) & LIN_ID_MASK))
+#define LIN_PID_P0(id)  ((uint8_t)(((id) ^ ((id) >> 1) ^ ((id) >> 2) ^ ((id) >> 4)) & 1U))
+#define LIN_PID_P1(id)  ((uint8_t)(~(((id) >> 1) ^ ((id) >> 3) ^ ((id) >> 4) ^ ((id) >> 5)) & 1U))
+#define LIN_PID(id)     ((uint8_t)(((id) & LIN_ID_MASK) | (LIN_PID_P0(id) << 6) | (LIN_PID_P1(id) << 7))) /* Protected identifier */
+#define LIN_PID_VALID(pid) (LIN_PID(LIN_PID_ID(pid)) == (uint8_t)(pid))
+
+#define LIN_ID_DIAG(id)   ((uint8_t)(id) >= 0x3cU) /* Diagnostic frames use the classic checksum */
+#define LIN_ID_LENGTH(id) ((uint8_t)(((id) < 0x20U) ? 2U : (((id) < 0x30U) ? 4U : 8U))) /* LIN 1.x data length */
+
+/* Enhanced checksum (classic for diagnostic IDs), one byte at a time:
+  an 8-bit sum with the carry added back in, inverted at the end */
+#define LIN_CSUM_INIT(pid)   ((uint16_t)(LIN_ID_DIAG(LIN_PID_ID(pid)) ? 0U : (uint8_t)(pid)))
+#define LIN_CSUM_ADD(sum, b) ((sum) = (uint16_t)((sum) + (uint8_t)(b)), (sum) = (uint16_t)(((sum) & 0xffU) + ((sum) >> 8)))
+#define LIN_CSUM_FINAL(sum)  ((uint8_t)~(uint8_t)(sum))
+
+/* Maximum frame time in microseconds with n data bytes at baud bit/s:
+  1.4 times the nominal 34 header bits plus 10 bits per data and checksum byte */
+#define LIN_FRAME_MAX_US(baud, n)    ((14UL * (34UL + (10UL * ((n) + 1UL))) * 100000UL) / (baud))
+#define LIN_RESPONSE_MAX_US(baud, n) ((14UL * 10UL * ((n) + 1UL) * 100000UL) / (baud))
+
+#define LIN_SLAVE_STATE_IDLE (0U) /* Dormant, waiting for a break */
+#define LIN_SLAVE_STATE_PID  (1U) /* Break and synch received, next byte is the PID */
+#define LIN_SLAVE_STATE_DATA (2U) /* Response data and checksum */
+
+#define LIN_SLAVE_IGNORE    (0U) /* LOOKUP result: frame not handled by this node */
+#define LIN_SLAVE_SUBSCRIBE (1U) /* LOOKUP result: receive the response into DATA */
+#define LIN_SLAVE_PUBLISH   (2U) /* LOOKUP result: send DATA as the response */
+
+#define LIN_SLAVE_DROP_(lin)                                                                              \
+  do {                                                                                                    \
+    (lin).ERRORS++;                                                                                       \
+    (lin).STATE = LIN_SLAVE_STATE_IDLE;                                                                   \
+    USCI_UART_RX_DORMANT();                                                                               \
+  } while (0)
+
+#define LIN_SLAVE_RX(lin, stat, c)                                                                        \
+  do {                                                                                                    \
+    if (((stat) & USCI_UART_STAT_UCBRK_MASK) != 0U) {                                                     \
+      if (USCI_UART_ABCTL_LIN_ERROR) {                                                                    \
+        UCA0_UART->ABCTL &= (uint8_t)~USCI_UART_ABCTL_ERR_MASK;                                           \
+        LIN_SLAVE_DROP_(lin);                                                                             \
+      } else {                                                                                            \
+        (lin).STATE = LIN_SLAVE_STATE_PID;                                                                \
+        USCI_UART_RX_AWAKE();                                                                             \
+      }                                                                                                   \
+      break;                                                                                              \
+    }                                                                                                     \
+    if (((stat) & USCI_UART_STAT_UCRXERR_MASK) != 0U) {                                                   \
+      LIN_SLAVE_DROP_(lin);                                                                               \
+      break;                                                                                              \
+    }                                                                                                     \
+    if ((lin).STATE == LIN_SLAVE_STATE_PID) {                                                             \
+      (lin).PID  = (uint8_t)(c);                                                                          \
+      (lin).SUM  = LIN_CSUM_INIT(c);                                                                      \
+      (lin).LEN  = LIN_ID_LENGTH(LIN_PID_ID(c));                                                          \
+      (lin).POS  = 0U;                                                                                    \
+      (lin).MODE = LIN_PID_VALID(c) ? (lin).LOOKUP(&(lin)) : LIN_SLAVE_IGNORE;                            \
+      if ((lin).MODE == LIN_SLAVE_IGNORE || (uint8_t)((lin).LEN - 1U) >= sizeof((lin).DATA)) {            \
+        (lin).STATE = LIN_SLAVE_STATE_IDLE;                                                               \
+        USCI_UART_RX_DORMANT();                                                                           \
+        break;                                                                                            \
+      }                                                                                                   \
+      (lin).STATE = LIN_SLAVE_STATE_DATA;                                                                 \
+      if ((lin).MODE == LIN_SLAVE_PUBLISH) {                                                              \
+        UCA0_UART->TXBUF = (lin).DATA[0];                                                                 \
+      }                                                                                                   \
+    } else if ((lin).STATE == LIN_SLAVE_STATE_DATA) {                                                     \
+      if ((lin).POS < (lin).LEN) {                                                                        \
+        if ((lin).MODE == LIN_SLAVE_PUBLISH && (uint8_t)(c) != (lin).DATA[(lin).POS]) {                   \
+          LIN_SLAVE_DROP_(lin);                                                                           \
+          break;                                                                                          \
+        }                                                                                                 \
+        (lin).DATA[(lin).POS++] = (uint8_t)(c);                                                           \
+        LIN_CSUM_ADD((lin).SUM, c);                                                                       \
+        if ((lin).MODE == LIN_SLAVE_PUBLISH) {                                                            \
+          UCA0_UART->TXBUF =                                                                              \
+            ((lin).POS < (lin).LEN) ? (lin).DATA[(lin).POS] : LIN_CSUM_FINAL((lin).SUM);                  \
+        }                                                                                                 \
+      } else if ((uint8_t)(c) != LIN_CSUM_FINAL((lin).SUM)) {                                             \
+        LIN_SLAVE_DROP_(lin);                                                                             \
+      } else {                                                                                            \
+        (lin).STATE = LIN_SLAVE_STATE_IDLE;                                                               \
+        USCI_UART_RX_DORMANT();                                                                           \
+        if ((lin).MODE == LIN_SLAVE_SUBSCRIBE && (lin).DONE != 0) {                                       \
+          (lin).DONE(&(lin));                                                                             \
+        }                                                                                                 \
+      }                                                                                                   \
+    }                                                                                                     \
+  } while (0)
+
 /*****************************************************************************
 * @brief UCSI_SPI_CTL0
 *****************************************************************************/
@@ -2195,6 +3108,194 @@ by: tMIN = (UCIRRXFLx + 4) / (2 ? fBRCLK) */
   1b = USCI transmitting or receiving */
 #define UCSI_SPI_STAT_UCBUSY(x)    (((uint8_t)(((uint8_t)(x)) << UCSI_SPI_STAT_UCBUSY_SHIFT)) & UCSI_SPI_STAT_UCBUSY_MASK)
 
+/* IFG2 flags of each SPI instance, named so that USCI_SPI_BURST_* can
+  take the instance (UCA0 or UCB0) as a single token */
+#define UCA0_SPI_TXIFG IFG2_UCA0TXIFG_MASK
+#define UCA0_SPI_RXIFG IFG2_UCA0RXIFG_MASK
+#define UCB0_SPI_TXIFG IFG2_UCB0TXIFG_MASK
+#define UCB0_SPI_RXIFG IFG2_UCB0RXIFG_MASK
+
+/* Polled SPI master bursts on UCA0 or UCB0, e.g.
+  USCI_SPI_BURST_TX(UCB0, buf, n).
+  TXBUF is double buffered: the next byte is written as soon as TXIFG
+  shows the previous one has moved to the shift register, so there is
+  no gap between bytes as long as the loop is faster than the byte
+  time (8 * UCBRx BRCLK cycles).
+  TX: about 14 CPU cycles per byte (poll, MOV.B @Rn+, loop), so with
+  SMCLK = MCLK = 16 MHz and UCBRx = 2 (16 cycles per byte) the bus runs
+  at 8 Mbit/s. RX is not read per byte; at the end the loop waits for
+  UCBUSY to clear and reads RXBUF once to clear RXIFG and UCOE.
+  Full duplex and RX: one byte is kept in flight ahead of the one being
+  read, about 24 CPU cycles per byte, so UCBRx = 2 gives about 5 Mbit/s
+  and UCBRx = 3 keeps the bus busy. RX sends fill for every byte.
+  Byte i + 1 is already shifting when byte i is read, so an interrupt
+  between the two longer than one byte time overruns RXBUF and loses
+  data without notice. These bursts therefore run with GIE cleared (and
+  restored afterwards), which delays every interrupt by up to n byte
+  times; split long transfers where that matters, or use the queue.
+  n must be at least 1 for USCI_SPI_BURST_XFER and USCI_SPI_BURST_RX. */
+#define USCI_SPI_BURST_TX(inst, buf, n)                                       \
+  do {                                                                        \
+    const uint8_t *p_ = (const uint8_t *)(buf);                               \
+    const uint8_t *end_ = p_ + (n);                                           \
+    while (p_ != end_) {                                                      \
+      while ((SFR->IFG2 & inst##_SPI_TXIFG) == 0U) {                          \
+      }                                                                       \
+      inst##_SPI->TXBUF = *p_++;                                              \
+    }                                                                         \
+    while ((inst##_SPI->STAT & UCSI_SPI_STAT_UCBUSY_MASK) != 0U) {            \
+    }                                                                         \
+    (void)inst##_SPI->RXBUF;                                                  \
+  } while (0)
+
+#define USCI_SPI_BURST_(inst, next, rx, n)                                    \
+  do {                                                                        \
+    uint8_t *r_ = (uint8_t *)(rx);                                            \
+    uint8_t *last_ = r_ + (n) - 1;                                            \
+    uint16_t sr_ = (uint16_t)(__get_SR_register() & GIE);                     \
+    __bic_SR_register(GIE);                                                   \
+    __no_operation();                                                         \
+    (void)inst##_SPI->RXBUF;                                                  \
+    inst##_SPI->TXBUF = (next);                                               \
+    while (r_ != last_) {                                                     \
+      while ((SFR->IFG2 & inst##_SPI_TXIFG) == 0U) {                          \
+      }                                                                       \
+      inst##_SPI->TXBUF = (next);                                             \
+      while ((SFR->IFG2 & inst##_SPI_RXIFG) == 0U) {                          \
+      }                                                                       \
+      *r_++ = inst##_SPI->RXBUF;                                              \
+    }                                                                         \
+    while ((SFR->IFG2 & inst##_SPI_RXIFG) == 0U) {                            \
+    }                                                                         \
+    *r_ = inst##_SPI->RXBUF;                                                  \
+    __bis_SR_register(sr_);                                                   \
+  } while (0)
+
+#define USCI_SPI_BURST_XFER(inst, tx, rx, n)                                  \
+  do {                                                                        \
+    const uint8_t *t_ = (const uint8_t *)(tx);                                \
+    USCI_SPI_BURST_(inst, *t_++, rx, n);                                      \
+  } while (0)
+
+#define USCI_SPI_BURST_RX(inst, rx, n, fill) USCI_SPI_BURST_(inst, (uint8_t)(fill), rx, n)
+
+/* Interrupt-driven SPI master transaction queue on UCA0 or UCB0.
+  q is a ring of n (RING_IS_POW2) USCI_SPI_XFER_Type pointers with head
+  written by the main loop and tail by the USCIAB0RX_VECTOR handler,
+  which calls USCI_SPI_QUEUE_RX. One byte is in flight at a time and
+  each RX interrupt stores it and loads the next, so the CPU can sleep in
+  LPM0 for the whole transfer. On the last byte the chip select goes
+  high, the next queued descriptor starts and then DONE runs, from
+  interrupt context: it can set a flag, post an event or call
+  USCI_SPI_QUEUE_POST for a follow-up transfer.
+  USCI_SPI_XFER_START only holds the USCI in reset to load CTL0 and the
+  prescaler when they differ from the previous transfer, so repeated
+  transfers to one device cost no reconfiguration; the reset also clears
+  the RX interrupt enable, which is set again afterwards.
+  USCI_SPI_QUEUE_POST masks the RX interrupt around the ring update so
+  the handler cannot finish the last transfer between the head update
+  and the idle check; a byte completing meanwhile stays pending in RXIFG. */
+#define UCA0_SPI_RXIE IE2_UCA0RXIE_MASK
+#define UCB0_SPI_RXIE IE2_UCB0RXIE_MASK
+
+#define USCI_SPI_XFER_START(inst, x)                                                                      \
+  do {                                                                                                    \
+    USCI_SPI_XFER_Type *s_ = (x);                                                                         \
+    if ((inst##_SPI->CTL0 != s_->CTL0) || (inst##_SPI->BR0 != s_->BR0) || (inst##_SPI->BR1 != s_->BR1)) { \
+      inst##_SPI->CTL1 |= UCSI_SPI_CTL1_UCSWRST_MASK;                                                     \
+      inst##_SPI->CTL0 = s_->CTL0;                                                                        \
+      inst##_SPI->BR0 = s_->BR0;                                                                          \
+      inst##_SPI->BR1 = s_->BR1;                                                                          \
+      inst##_SPI->CTL1 &= (uint8_t)~UCSI_SPI_CTL1_UCSWRST_MASK;                                           \
+    }                                                                                                     \
+    s_->POS = 0U;                                                                                         \
+    *s_->CS_OUT &= (uint8_t)~s_->CS;                                                                      \
+    SFR->IE2 |= inst##_SPI_RXIE;                                                                          \
+    inst##_SPI->TXBUF = (s_->TX != 0) ? s_->TX[0] : 0xffU;                                                \
+  } while (0)
+
+#define USCI_SPI_QUEUE_POST(inst, q, head, tail, n, x)                                                    \
+  do {                                                                                                    \
+    SFR->IE2 &= (uint8_t)~inst##_SPI_RXIE;                                                                \
+    (q)[RING_SLOT(head, n)] = (x);                                                                        \
+    (head)++;                                                                                             \
+    if (RING_COUNT(head, tail) == 1U) {                                                                   \
+      USCI_SPI_XFER_START(inst, x);                                                                       \
+    } else {                                                                                              \
+      SFR->IE2 |= inst##_SPI_RXIE;                                                                        \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_SPI_QUEUE_RX(inst, q, head, tail, n)                                                         \
+  do {                                                                                                    \
+    USCI_SPI_XFER_Type *x_ = (q)[RING_SLOT(tail, n)];                                                     \
+    uint8_t c_ = inst##_SPI->RXBUF;                                                                       \
+    if (x_->RX != 0) {                                                                                    \
+      x_->RX[x_->POS] = c_;                                                                               \
+    }                                                                                                     \
+    if (++x_->POS < x_->LEN) {                                                                            \
+      inst##_SPI->TXBUF = (x_->TX != 0) ? x_->TX[x_->POS] : 0xffU;                                        \
+      break;                                                                                              \
+    }                                                                                                     \
+    *x_->CS_OUT |= x_->CS;                                                                                \
+    (tail)++;                                                                                             \
+    if (RING_EMPTY(head, tail)) {                                                                         \
+      SFR->IE2 &= (uint8_t)~inst##_SPI_RXIE;                                                              \
+    } else {                                                                                              \
+      USCI_SPI_XFER_START(inst, (q)[RING_SLOT(tail, n)]);                                                 \
+    }                                                                                                     \
+    if (x_->DONE != 0) {                                                                                  \
+      x_->DONE(x_);                                                                                       \
+    }                                                                                                     \
+  } while (0)
+
+/* Double-buffered SPI slave on UCA0 for a host that reads fixed-size
+  snapshots. UCA0CTL0 is set up with USCI_SPI_CTL0_SLAVE_4PIN_AL and the
+  host's chip select drives UCA0STE (P1.5), so the USCI ignores SCLK
+  while it is high. buf is uint8_t[2][size]; buf[front] is what the host
+  reads and USCI_SPI_SLAVE_BACK the one the application fills. After
+  filling it the application sets pending = 1 and waits for pending == 0
+  (USCI_SPI_SLAVE_WRITABLE) before touching the back buffer again; the
+  swap only happens between host frames, so every frame is one complete
+  snapshot.
+  USCI_SPI_SLAVE_TX runs in USCIAB0TX_VECTOR for UCA0TXIFG and loads one
+  byte per interrupt while the previous one shifts out, so it has a full
+  byte time (32 MCLK cycles at 4 MHz SCLK and 16 MHz MCLK) per entry and
+  does a fixed amount of work. It stops at the end of the snapshot.
+  USCI_SPI_SLAVE_END runs on the rising edge of the chip select, from a
+  port interrupt on a pin wired to it: it resets the USCI to drop any
+  partial byte of an aborted frame, swaps in a pending snapshot and arms
+  TXBUF with its first byte before the host selects the slave again.
+  Received bytes are not read. */
+#define USCI_SPI_CTL0_SLAVE_4PIN_AL(ckph, ckpl)                                                           \
+  ((uint8_t)(USCI_SPI_CTL0_UCCKPH(ckph) | USCI_SPI_CTL0_UCCKPL(ckpl) | USCI_SPI_CTL0_UCMSB(1U) |         \
+             USCI_SPI_CTL0_UCMODE(USCI_SPI_CTL0_UCMODE_4PIN_SPI_AL) | USCI_SPI_CTL0_UCSYNC(1U)))
+
+#define USCI_SPI_SLAVE_BACK(buf, front) ((buf)[(front) ^ 1U])
+#define USCI_SPI_SLAVE_WRITABLE(pending) ((pending) == 0U)
+
+#define USCI_SPI_SLAVE_TX(buf, front, pos, size)                                                          \
+  do {                                                                                                    \
+    if (++(pos) < (size)) {                                                                               \
+      UCA0_SPI->TXBUF = (buf)[front][pos];                                                                \
+    } else {                                                                                              \
+      SFR->IE2 &= (uint8_t)~IE2_UCA0TXIE_MASK;                                                            \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_SPI_SLAVE_END(buf, front, pending, pos)                                                      \
+  do {                                                                                                    \
+    UCA0_SPI->CTL1 |= UCSI_SPI_CTL1_UCSWRST_MASK;                                                         \
+    if ((pending) != 0U) {                                                                                \
+      (front) ^= 1U;                                                                                      \
+      (pending) = 0U;                                                                                     \
+    }                                                                                                     \
+    (pos) = 0U;                                                                                           \
+    UCA0_SPI->CTL1 &= (uint8_t)~UCSI_SPI_CTL1_UCSWRST_MASK;                                               \
+    UCA0_SPI->TXBUF = (buf)[front][0];                                                                    \
+    SFR->IE2 |= IE2_UCA0TXIE_MASK;                                                                        \
+  } while (0)
+
 /*****************************************************************************
 * @brief UCSI_I2C_CTL0
 *****************************************************************************/
@@ -2321,6 +3422,42 @@ by: tMIN = (UCIRRXFLx + 4) / (2 ? fBRCLK) */
 #define USCI_I2C_CTL1_UCSSEL_SMCLK    (2U) /* USCI clock source select: SMCLK */
 #define USCI_I2C_CTL1_UCSSEL_SMCLK2   (3U) /* USCI clock source select: SMCLKs */
 
+/*****************************************************************************
+* @brief UCSI_I2C_IE
+*****************************************************************************/
+
+/* UCSI_I2C_IE_UCNACKIE */
+#define UCSI_I2C_IE_UCNACKIE_MASK  (0x8U)
+#define UCSI_I2C_IE_UCNACKIE_SHIFT (0x3U)
+/* Not-acknowledge interrupt enable
+  0b = Interrupt disabled
+  1b = Interrupt enabled */
+#define UCSI_I2C_IE_UCNACKIE(x)    (((uint8_t)(((uint8_t)(x)) << UCSI_I2C_IE_UCNACKIE_SHIFT)) & UCSI_I2C_IE_UCNACKIE_MASK)
+
+/* UCSI_I2C_IE_UCSTPIE */
+#define UCSI_I2C_IE_UCSTPIE_MASK  (0x4U)
+#define UCSI_I2C_IE_UCSTPIE_SHIFT (0x2U)
+/* Stop condition interrupt enable
+  0b = Interrupt disabled
+  1b = Interrupt enabled */
+#define UCSI_I2C_IE_UCSTPIE(x)    (((uint8_t)(((uint8_t)(x)) << UCSI_I2C_IE_UCSTPIE_SHIFT)) & UCSI_I2C_IE_UCSTPIE_MASK)
+
+/* UCSI_I2C_IE_UCSTTIE */
+#define UCSI_I2C_IE_UCSTTIE_MASK  (0x2U)
+#define UCSI_I2C_IE_UCSTTIE_SHIFT (0x1U)
+/* Start condition interrupt enable
+  0b = Interrupt disabled
+  1b = Interrupt enabled */
+#define UCSI_I2C_IE_UCSTTIE(x)    (((uint8_t)(((uint8_t)(x)) << UCSI_I2C_IE_UCSTTIE_SHIFT)) & UCSI_I2C_IE_UCSTTIE_MASK)
+
+/* UCSI_I2C_IE_UCALIE */
+#define UCSI_I2C_IE_UCALIE_MASK  (0x1U)
+#define UCSI_I2C_IE_UCALIE_SHIFT (0x0U)
+/* Arbitration lost interrupt enable
+  0b = Interrupt disabled
+  1b = Interrupt enabled */
+#define UCSI_I2C_IE_UCALIE(x)    (((uint8_t)(((uint8_t)(x)) << UCSI_I2C_IE_UCALIE_SHIFT)) & UCSI_I2C_IE_UCALIE_MASK)
+
 /*****************************************************************************
 * @brief UCSI_I2C_STAT
 *****************************************************************************/
@@ -2416,6 +3553,443 @@ by: tMIN = (UCIRRXFLx + 4) / (2 ? fBRCLK) */
   slave addressing mode, bit 9 is the MSB. */
 #define UCSI_I2C_ADDR_I2CSA_I2CSA(x)    (((uint16_t)(((uint16_t)(x)) << UCSI_I2C_ADDR_I2CSA_I2CSA_SHIFT)) & UCSI_I2C_ADDR_I2CSA_I2CSA_MASK)
 
+/* UCB0BR0/UCB0BR1 prescaler for an SCL of at most scl Hz from a BRCLK of fclk Hz */
+#define USCI_I2C_BR_FOR(fclk, scl) ((uint16_t)(((fclk) + (scl) - 1UL) / (scl)))
+
+/* Interrupt-driven I2C master on UCB0.
+  Each USCI_I2C_XFER_Type writes TXLEN bytes and then, after a repeated
+  start, reads RXLEN bytes; one of the two may be 0. q is a ring of n
+  (RING_IS_POW2) descriptor pointers, filled with USCI_I2C_MASTER_POST by
+  the main loop. UCB0 is set up as a single-master I2C master with
+  UCB0I2CIE = USCI_I2C_MASTER_IE.
+  In I2C mode the USCIAB0TX_VECTOR serves both UCB0TXIFG and UCB0RXIFG,
+  and USCI_I2C_MASTER_DATA moves one byte per interrupt and issues the
+  repeated start and stop. USCIAB0RX_VECTOR serves the state flags and
+  USCI_I2C_MASTER_STATE turns a NACK or lost arbitration into the
+  descriptor's STATUS. On completion the next descriptor starts and DONE
+  runs, as for USCI_SPI_QUEUE_RX. USCI_I2C_MASTER_POST masks both the
+  data and the state interrupts around the ring update.
+  STOP for a read is requested while the next-to-last byte is taken from
+  RXBUF, so no byte is clocked past RXLEN. For a write it is requested
+  when the last byte moves into the shift register, before the slave
+  has acknowledged it. Either way the descriptor then stays at the head
+  of the queue with USCI_I2C_STATUS_STOP set in STATUS, so a NACK of
+  the last byte is still charged to it. The USCI has no master-mode
+  interrupt for the end of the STOP, so the handler that requested it
+  polls UCTXSTP for at most USCI_I2C_STOP_SPIN iterations, about one
+  byte time, and then completes the descriptor, taking a pending
+  UCNACKIFG into account, and starts the next one. A write is the long
+  case: the last byte, its acknowledge and the STOP are still on the
+  bus, so USCIAB0TX_VECTOR runs for up to USCI_I2C_STOP_US. Reads and
+  NACKs wait only for the STOP itself. Should UCTXSTP still be set
+  after the spin (SCL stretched by the slave),
+  USCI_I2C_STOP_PENDING(x) is invoked and USCI_I2C_MASTER_IDLE, run
+  from the main loop or a timer, completes the descriptor later; define
+  the hook to schedule it, e.g. a TA_TIMER of USCI_I2C_STOP_US. DONE of
+  such descriptors runs in that context. USCI_I2C_MASTER_START clears
+  UCNACKIFG and UCALIFG left over from the previous transaction. The
+  hardware gives no event between the address acknowledge and the
+  first data bit, so a 1-byte read waits for UCTXSTT to clear before
+  requesting STOP, see USCI_I2C_MASTER_READ_. */
+#define USCI_I2C_STATUS_OK   (0U)    /* Transaction complete */
+#define USCI_I2C_STATUS_NACK (1U)    /* Address or data not acknowledged */
+#define USCI_I2C_STATUS_LOST (2U)    /* Arbitration lost */
+#define USCI_I2C_STATUS_RETRY (3U)   /* Arbitration lost, waiting for USCI_I2C_MASTER_RETRY */
+#define USCI_I2C_STATUS_BUSY (0xffU) /* Queued or in progress */
+#define USCI_I2C_STATUS_STOP (0x80U) /* Flag: result in the low bits, STOP still going out */
+
+#define USCI_I2C_STATUS_STOPPING(s) (((uint8_t)(s) & 0xfcU) == USCI_I2C_STATUS_STOP)
+
+/* Time from the last data interrupt of a write until the STOP is out: the last byte, its acknowledge and the STOP */
+#define USCI_I2C_STOP_US(scl) ((11000000UL + (scl) - 1UL) / (scl))
+
+/* UCTXSTP polls covering USCI_I2C_STOP_US at mclk Hz, about 8 CPU cycles per poll */
+#define USCI_I2C_STOP_SPIN_FOR(mclk, scl) ((uint16_t)((((mclk) / 1000UL) * USCI_I2C_STOP_US(scl) + 7999UL) / 8000UL))
+
+#ifndef USCI_I2C_STOP_SPIN
+#define USCI_I2C_STOP_SPIN USCI_I2C_STOP_SPIN_FOR(MSP430_MCLK_HZ, 100000UL) /* Bound for SCL >= 100 kHz */
+#endif
+
+#ifndef USCI_I2C_STOP_PENDING
+#define USCI_I2C_STOP_PENDING(x) ((void)(x))
+#endif
+
+#define USCI_I2C_MASTER_IE (UCSI_I2C_IE_UCNACKIE_MASK | UCSI_I2C_IE_UCALIE_MASK)
+#define USCI_I2C_DATA_IE   (IE2_UCB0TXIE_MASK | IE2_UCB0RXIE_MASK)
+#define USCI_I2C_DATA_IFG  (IFG2_UCB0TXIFG_MASK | IFG2_UCB0RXIFG_MASK)
+
+#define USCI_I2C_MASTER_START(x)                                                                          \
+  do {                                                                                                    \
+    USCI_I2C_XFER_Type *s_ = (x);                                                                         \
+    UCB0_I2C_ADDR->I2CSA = s_->ADDR;                                                                      \
+    UCB0_I2C->CTL0 |= USCI_I2C_CTL0_UCMST_MASK;                                                           \
+    UCB0_I2C->STAT &= (uint8_t)~(UCSI_I2C_STAT_UCNACKIFG_MASK | UCSI_I2C_STAT_UCALIFG_MASK);              \
+    s_->POS = 0U;                                                                                         \
+    SFR->IFG2 &= (uint8_t)~USCI_I2C_DATA_IFG;                                                             \
+    SFR->IE2 |= USCI_I2C_DATA_IE;                                                                         \
+    if (s_->TXLEN != 0U) {                                                                                \
+      UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCTR_MASK | UCSI_I2C_CTL1_UCTXSTT_MASK;                             \
+    } else {                                                                                              \
+      USCI_I2C_MASTER_READ_(s_);                                                                          \
+    }                                                                                                     \
+  } while (0)
+
+/* Worst case of the data handler: for RXLEN = 1 the UCTXSTT poll lasts
+  the rest of the current byte plus the address, 18 SCL periods (180 us
+  at 100 kHz), with the same bound for a repeated start from
+  USCIAB0TX_VECTOR. Keep single-byte reads off buses whose other
+  interrupts cannot wait that long. */
+#define USCI_I2C_MASTER_READ_(x)                                                                          \
+  do {                                                                                                    \
+    UCB0_I2C->CTL1 &= (uint8_t)~UCSI_I2C_CTL1_UCTR_MASK;                                                  \
+    UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCTXSTT_MASK;                                                         \
+    if ((x)->RXLEN == 1U) {                                                                               \
+      while ((UCB0_I2C->CTL1 & UCSI_I2C_CTL1_UCTXSTT_MASK) != 0U) {                                       \
+      }                                                                                                   \
+      UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCTXSTP_MASK;                                                       \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_I2C_MASTER_DONE_(q, head, tail, n, x, status)                                                \
+  do {                                                                                                    \
+    (x)->STATUS = (status);                                                                               \
+    (tail)++;                                                                                             \
+    if (RING_EMPTY(head, tail)) {                                                                         \
+      SFR->IE2 &= (uint8_t)~USCI_I2C_DATA_IE;                                                             \
+    } else {                                                                                              \
+      USCI_I2C_MASTER_START((q)[RING_SLOT(tail, n)]);                                                     \
+    }                                                                                                     \
+    if ((x)->DONE != 0) {                                                                                 \
+      (x)->DONE(x);                                                                                       \
+    }                                                                                                     \
+  } while (0)
+
+/* STOP of x is out: complete it, a late NACK of the last byte included */
+#define USCI_I2C_MASTER_STOPPED_(q, head, tail, n, x)                                                     \
+  do {                                                                                                    \
+    uint8_t st_ = (uint8_t)((x)->STATUS & (uint8_t)~USCI_I2C_STATUS_STOP);                                \
+    if ((UCB0_I2C->STAT & UCSI_I2C_STAT_UCNACKIFG_MASK) != 0U) {                                          \
+      st_ = USCI_I2C_STATUS_NACK;                                                                         \
+    }                                                                                                     \
+    USCI_I2C_MASTER_DONE_(q, head, tail, n, x, st_);                                                      \
+  } while (0)
+
+/* STOP requested for x: wait for it up to USCI_I2C_STOP_SPIN polls, else
+  hold x at the head until USCI_I2C_MASTER_IDLE */
+#define USCI_I2C_MASTER_STOPPING_(q, head, tail, n, x, status)                                            \
+  do {                                                                                                    \
+    uint16_t spin_ = USCI_I2C_STOP_SPIN;                                                                  \
+    SFR->IE2 &= (uint8_t)~USCI_I2C_DATA_IE;                                                               \
+    (x)->STATUS = (uint8_t)(USCI_I2C_STATUS_STOP | (status));                                             \
+    while (((UCB0_I2C->CTL1 & UCSI_I2C_CTL1_UCTXSTP_MASK) != 0U) && (--spin_ != 0U)) {                    \
+    }                                                                                                     \
+    if ((UCB0_I2C->CTL1 & UCSI_I2C_CTL1_UCTXSTP_MASK) == 0U) {                                            \
+      USCI_I2C_MASTER_STOPPED_(q, head, tail, n, x);                                                      \
+    } else {                                                                                              \
+      USCI_I2C_STOP_PENDING(x);                                                                           \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_I2C_MASTER_POST(q, head, tail, n, x)                                                         \
+  do {                                                                                                    \
+    uint8_t ie2_ = (uint8_t)(SFR->IE2 & USCI_I2C_DATA_IE);                                                \
+    SFR->IE2 &= (uint8_t)~USCI_I2C_DATA_IE;                                                               \
+    UCB0_I2C->IE = 0U;                                                                                    \
+    (x)->STATUS = USCI_I2C_STATUS_BUSY;                                                                   \
+    (q)[RING_SLOT(head, n)] = (x);                                                                        \
+    (head)++;                                                                                             \
+    if (RING_COUNT(head, tail) == 1U) {                                                                   \
+      USCI_I2C_MASTER_START(x);                                                                           \
+    } else {                                                                                              \
+      SFR->IE2 |= ie2_;                                                                                   \
+    }                                                                                                     \
+    UCB0_I2C->IE = USCI_I2C_MASTER_IE;                                                                    \
+  } while (0)
+
+#define USCI_I2C_MASTER_DATA(q, head, tail, n)                                                            \
+  do {                                                                                                    \
+    USCI_I2C_XFER_Type *x_ = (q)[RING_SLOT(tail, n)];                                                     \
+    if ((SFR->IFG2 & IFG2_UCB0RXIFG_MASK) != 0U) {                                                        \
+      if ((uint8_t)(x_->RXLEN - x_->POS) == 2U) {                                                         \
+        UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCTXSTP_MASK;                                                     \
+      }                                                                                                   \
+      x_->RX[x_->POS++] = UCB0_I2C->RXBUF;                                                                \
+      if (x_->POS == x_->RXLEN) {                                                                         \
+        USCI_I2C_MASTER_STOPPING_(q, head, tail, n, x_, USCI_I2C_STATUS_OK);                              \
+      }                                                                                                   \
+    } else if (x_->POS < x_->TXLEN) {                                                                     \
+      UCB0_I2C->TXBUF = x_->TX[x_->POS++];                                                                \
+    } else {                                                                                              \
+      SFR->IFG2 &= (uint8_t)~IFG2_UCB0TXIFG_MASK;                                                         \
+      x_->POS = 0U;                                                                                       \
+      if (x_->RXLEN != 0U) {                                                                              \
+        USCI_I2C_MASTER_READ_(x_);                                                                        \
+      } else {                                                                                            \
+        UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCTXSTP_MASK;                                                     \
+        USCI_I2C_MASTER_STOPPING_(q, head, tail, n, x_, USCI_I2C_STATUS_OK);                              \
+      }                                                                                                   \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_I2C_MASTER_STATE(q, head, tail, n)                                                           \
+  do {                                                                                                    \
+    USCI_I2C_XFER_Type *x_ = (q)[RING_SLOT(tail, n)];                                                     \
+    uint8_t stat_ = UCB0_I2C->STAT;                                                                       \
+    UCB0_I2C->STAT &= (uint8_t)~(UCSI_I2C_STAT_UCNACKIFG_MASK | UCSI_I2C_STAT_UCALIFG_MASK);              \
+    if (RING_EMPTY(head, tail)) {                                                                         \
+      break;                                                                                              \
+    }                                                                                                     \
+    SFR->IFG2 &= (uint8_t)~USCI_I2C_DATA_IFG;                                                             \
+    if ((stat_ & UCSI_I2C_STAT_UCNACKIFG_MASK) != 0U) {                                                   \
+      if (!USCI_I2C_STATUS_STOPPING(x_->STATUS)) {                                                        \
+        UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCTXSTP_MASK;                                                     \
+      }                                                                                                   \
+      USCI_I2C_MASTER_STOPPING_(q, head, tail, n, x_, USCI_I2C_STATUS_NACK);                              \
+    } else if ((stat_ & UCSI_I2C_STAT_UCALIFG_MASK) != 0U) {                                              \
+      if (x_->TRIES != 0U) {                                                                              \
+        x_->TRIES--;                                                                                      \
+        x_->STATUS = USCI_I2C_STATUS_RETRY;                                                               \
+        SFR->IE2 &= (uint8_t)~USCI_I2C_DATA_IE;                                                           \
+      } else {                                                                                            \
+        USCI_I2C_MASTER_DONE_(q, head, tail, n, x_, USCI_I2C_STATUS_LOST);                                \
+      }                                                                                                   \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_I2C_MASTER_IDLE(q, head, tail, n)                                                            \
+  do {                                                                                                    \
+    USCI_I2C_XFER_Type *x_ = (q)[RING_SLOT(tail, n)];                                                     \
+    UCB0_I2C->IE = 0U;                                                                                    \
+    if (!RING_EMPTY(head, tail) && USCI_I2C_STATUS_STOPPING(x_->STATUS) &&                                \
+        ((UCB0_I2C->CTL1 & UCSI_I2C_CTL1_UCTXSTP_MASK) == 0U)) {                                          \
+      USCI_I2C_MASTER_STOPPED_(q, head, tail, n, x_);                                                     \
+    }                                                                                                     \
+    UCB0_I2C->IE = USCI_I2C_MASTER_IE;                                                                    \
+  } while (0)
+
+/* Multi-master operation (UCMM set in UCB0CTL0).
+  On lost arbitration the USCI falls back to slave mode. A descriptor
+  with TRIES left stays at the head of the queue with STATUS
+  USCI_I2C_STATUS_RETRY; after USCI_I2C_BACKOFF_US the application (a
+  timer callback) calls USCI_I2C_MASTER_RETRY, which restarts it once
+  the USCI sees the bus free. The backoff grows with the attempt number
+  and is scaled by the low bits of the own address so two nodes that
+  collided do not retry in lockstep.
+  A stuck bus, typically a slave holding SDA low after a reset in the
+  middle of a byte, or a master that vanished before its STOP, keeps
+  UCBBUSY set. USCI_I2C_BUS_WATCH runs from a periodic tick and counts
+  the ticks over which UCBBUSY stays set while SCL and SDA do not change;
+  on a live bus they hardly ever read the same several ticks in a row.
+  Once USCI_I2C_BUS_STUCK(cnt, limit) holds, USCI_I2C_BUS_RECOVER takes
+  P1.6/P1.7 away from the USCI, clocks SCL up to nine times until the
+  slave releases SDA, generates a STOP and hands the pins back. wait is
+  a statement that delays half an SCL period. The USCI reset clears its
+  interrupt enables; they are restored afterwards. A transaction that
+  was in progress is restarted by setting its STATUS to
+  USCI_I2C_STATUS_RETRY. The worst-case stall is limit ticks plus about
+  20 SCL periods instead of a watchdog reset. */
+#define USCI_I2C_SCL_PIN (0x40U) /* P1.6 UCB0SCL */
+#define USCI_I2C_SDA_PIN (0x80U) /* P1.7 UCB0SDA */
+#define USCI_I2C_PINS    (USCI_I2C_SCL_PIN | USCI_I2C_SDA_PIN)
+
+#define USCI_I2C_BACKOFF_US(attempt, oa, scl) \
+  (((10000000UL / (scl)) << (attempt)) * (1UL + ((oa) & 3UL)))
+
+#define USCI_I2C_MASTER_RETRY(q, head, tail, n)                                                           \
+  do {                                                                                                    \
+    USCI_I2C_XFER_Type *x_ = (q)[RING_SLOT(tail, n)];                                                     \
+    if (!RING_EMPTY(head, tail) && (x_->STATUS == USCI_I2C_STATUS_RETRY) &&                               \
+        ((UCB0_I2C->STAT & UCSI_I2C_STAT_UCBBUSY_MASK) == 0U)) {                                          \
+      x_->STATUS = USCI_I2C_STATUS_BUSY;                                                                  \
+      USCI_I2C_MASTER_START(x_);                                                                          \
+    }                                                                                                     \
+  } while (0)
+
+#define USCI_I2C_BUS_WATCH(last, cnt)                                                                     \
+  do {                                                                                                    \
+    uint8_t pins_ = (uint8_t)(PIO1->IN & USCI_I2C_PINS);                                                  \
+    if (((UCB0_I2C->STAT & UCSI_I2C_STAT_UCBBUSY_MASK) != 0U) && (pins_ == (last))) {                     \
+      if ((cnt) != 0xffU) {                                                                               \
+        (cnt)++;                                                                                          \
+      }                                                                                                   \
+    } else {                                                                                              \
+      (cnt) = 0U;                                                                                         \
+    }                                                                                                     \
+    (last) = pins_;                                                                                       \
+  } while (0)
+
+#define USCI_I2C_BUS_STUCK(cnt, limit) ((cnt) >= (limit))
+
+#define USCI_I2C_BUS_RECOVER(wait)                                                                        \
+  do {                                                                                                    \
+    uint8_t ie_ = UCB0_I2C->IE;                                                                           \
+    uint8_t ie2_ = (uint8_t)(SFR->IE2 & USCI_I2C_DATA_IE);                                                \
+    uint8_t i_;                                                                                           \
+    UCB0_I2C->CTL1 |= UCSI_I2C_CTL1_UCSWRST_MASK;                                                         \
+    PIO1->OUT &= (uint8_t)~USCI_I2C_PINS;                                                                 \
+    PIO1->DIR &= (uint8_t)~USCI_I2C_PINS;                                                                 \
+    PIO1->SEL &= (uint8_t)~USCI_I2C_PINS;                                                                 \
+    PIO_SEL2->P1SEL2 &= (uint8_t)~USCI_I2C_PINS;                                                          \
+    for (i_ = 0U; (i_ < 9U) && ((PIO1->IN & USCI_I2C_SDA_PIN) == 0U); i_++) {                             \
+      PIO1->DIR |= USCI_I2C_SCL_PIN;                                                                      \
+      wait;                                                                                               \
+      PIO1->DIR &= (uint8_t)~USCI_I2C_SCL_PIN;                                                            \
+      wait;                                                                                               \
+    }                                                                                                     \
+    PIO1->DIR |= USCI_I2C_SCL_PIN;                                                                        \
+    wait;                                                                                                 \
+    PIO1->DIR |= USCI_I2C_SDA_PIN;                                                                        \
+    wait;                                                                                                 \
+    PIO1->DIR &= (uint8_t)~USCI_I2C_SCL_PIN;                                                              \
+    wait;                                                                                                 \
+    PIO1->DIR &= (uint8_t)~USCI_I2C_SDA_PIN;                                                              \
+    wait;                                                                                                 \
+    PIO1->SEL |= USCI_I2C_PINS;                                                                           \
+    PIO_SEL2->P1SEL2 |= USCI_I2C_PINS;                                                                    \
+    UCB0_I2C->CTL1 &= (uint8_t)~UCSI_I2C_CTL1_UCSWRST_MASK;                                               \
+    UCB0_I2C->IE = ie_;                                                                                   \
+    SFR->IE2 |= ie2_;                                                                                     \
+  } while (0)
+
+/* I2C slave register map on UCB0.
+  The map is declared once, e.g.
+    static USCI_I2C_SLAVE_Type regs = USCI_I2C_SLAVE_MAP(snap0, snap1, ctl, 8U, 12U, 16U);
+  UCB0 is set up as an I2C slave with UCB0I2COA = USCI_I2C_OA_FOR(addr, gc)
+  and UCB0I2CIE = USCI_I2C_SLAVE_IE, and IE2 enables UCB0TXIE and UCB0RXIE.
+  A write transaction sets the register pointer with its first byte and
+  stores the following bytes from there; a read transaction, usually
+  after a repeated start, returns bytes from the pointer. The pointer
+  auto-increments: after a write it is one past the last register
+  written, and after a read one past the last register the master
+  clocked out, so a following read without a pointer write continues
+  with the next register. The USCI asks for each byte while the
+  previous one is still shifting out, so a read loads one byte more
+  than the master takes; USCI_I2C_SLAVE_STATE steps the pointer back
+  over it at the STOP or repeated START that ends the read. Writes to read-only registers are ignored and
+  write-only or unmapped registers read as 0xff. With gc set, general
+  call writes go through the same map, so one broadcast can update
+  every node.
+  Multi-byte values stay consistent: the application fills all RO
+  registers of USCI_I2C_SLAVE_BACK, sets PENDING and waits for PENDING
+  to clear before filling it again. The buffers are swapped only at the
+  START of a read, so a read never mixes two snapshots.
+  USCI_I2C_SLAVE_DATA (USCIAB0TX_VECTOR) does a fixed amount of work per
+  byte, so SCL is only stretched for the interrupt latency.
+  USCI_I2C_SLAVE_STATE (USCIAB0RX_VECTOR) handles START and STOP and sets
+  WRITTEN when the master changed registers. */
+#define USCI_I2C_SLAVE_MAP(snap0, snap1, ctl, ro, wo, size) \
+  {{(snap0), (snap1)}, (ctl), (ro), (wo), (size), 0U, 0U, 0U, 0U, 0U, 0U, 0U}
+
+#define USCI_I2C_OA_FOR(addr, gc) \
+  ((uint16_t)(UCSI_I2C_ADDR_I2COA_I2COA(addr) | UCSI_I2C_ADDR_I2COA_UCGCEN(gc)))
+
+#define USCI_I2C_SLAVE_IE         (UCSI_I2C_IE_UCSTPIE_MASK | UCSI_I2C_IE_UCSTTIE_MASK)
+#define USCI_I2C_SLAVE_BACK(m)    ((m).SNAP[(m).FRONT ^ 1U])
+#define USCI_I2C_SLAVE_WRITABLE(m) ((m).PENDING == 0U)
+
+#define USCI_I2C_SLAVE_DATA(m)                                                                            \
+  do {                                                                                                    \
+    uint8_t p_ = (m).PTR;                                                                                 \
+    if ((SFR->IFG2 & IFG2_UCB0RXIFG_MASK) != 0U) {                                                        \
+      uint8_t c_ = UCB0_I2C->RXBUF;                                                                       \
+      if ((m).FIRST != 0U) {                                                                              \
+        (m).FIRST = 0U;                                                                                   \
+        (m).PTR = c_;                                                                                     \
+        break;                                                                                            \
+      }                                                                                                   \
+      if ((p_ >= (m).RO) && (p_ < (m).SIZE)) {                                                            \
+        (m).CTL[p_ - (m).RO] = c_;                                                                        \
+        (m).DIRTY = 1U;                                                                                   \
+      }                                                                                                   \
+    } else if (p_ < (m).RO) {                                                                             \
+      UCB0_I2C->TXBUF = (m).SNAP[(m).FRONT][p_];                                                          \
+    } else if (p_ < (m).WO) {                                                                             \
+      UCB0_I2C->TXBUF = (m).CTL[p_ - (m).RO];                                                             \
+    } else {                                                                                              \
+      UCB0_I2C->TXBUF = 0xffU;                                                                            \
+    }                                                                                                     \
+    (m).PTR = (uint8_t)(p_ + 1U);                                                                         \
+  } while (0)
+
+#define USCI_I2C_SLAVE_STATE(m)                                                                           \
+  do {                                                                                                    \
+    uint8_t stat_ = UCB0_I2C->STAT;                                                                       \
+    UCB0_I2C->STAT &= (uint8_t)~(UCSI_I2C_STAT_UCSTTIFG_MASK | UCSI_I2C_STAT_UCSTPIFG_MASK);              \
+    if (((stat_ & UCSI_I2C_STAT_UCSTPIFG_MASK) != 0U) && ((m).DIRTY != 0U)) {                             \
+      (m).DIRTY = 0U;                                                                                     \
+      (m).WRITTEN = 1U;                                                                                   \
+    }                                                                                                     \
+    if (((m).READ != 0U) &&                                                                               \
+        ((stat_ & (UCSI_I2C_STAT_UCSTTIFG_MASK | UCSI_I2C_STAT_UCSTPIFG_MASK)) != 0U)) {                  \
+      (m).READ = 0U;                                                                                      \
+      (m).PTR--; /* The preloaded byte the master did not take */                                         \
+    }                                                                                                     \
+    if ((stat_ & UCSI_I2C_STAT_UCSTTIFG_MASK) != 0U) {                                                    \
+      if ((UCB0_I2C->CTL1 & UCSI_I2C_CTL1_UCTR_MASK) == 0U) {                                             \
+        (m).FIRST = 1U;                                                                                   \
+      } else {                                                                                            \
+        (m).READ = 1U;                                                                                    \
+        if ((m).PENDING != 0U) {                                                                          \
+          (m).FRONT ^= 1U;                                                                                \
+          (m).PENDING = 0U;                                                                               \
+        }                                                                                                 \
+      }                                                                                                   \
+    }                                                                                                     \
+  } while (0)
+
+/*****************************************************************************
+* @brief USCIAB0 interrupt dispatch
+*****************************************************************************/
+
+/* USCIAB0TX_VECTOR and USCIAB0RX_VECTOR are shared by UCA0 and UCB0.
+  USCI_DISPATCH lists one entry per source in priority order, e.g.
+    USCI_DISPATCH(USCI_B0_I2C_STATE(USCI_I2C_MASTER_STATE(q, head, tail, 4U))
+                  USCI_A0_RX(uart_rx()));
+  Entries are written one after the other without commas. Each entry is
+  an if/else on its flag, so the handler of the first pending source runs
+  and the handler returns; another pending source re-enters the vector.
+  Sources that are not listed generate no code, and #if can select
+  entries at compile time.
+  TX flags are set whenever a transmit buffer is empty, so TX entries
+  also test the interrupt enable; RX entries assume their enable is on
+  whenever the flag can be set. In I2C mode UCB0RXIFG is served by the
+  TX vector (USCI_B0_I2C_DATA) and the state flags by the RX vector.
+  Cycles from interrupt acceptance (6 cycles) to the first instruction
+  of entry k are 6 + the sum of the test costs of entries 1 .. k, plus
+  any registers the compiler saves in the prologue:
+    USCI_DISPATCH_CYCLES_IFG    BIT.B #n,&IFG2 + JZ            6
+    USCI_DISPATCH_CYCLES_IFG_IE MOV.B, AND.B, BIT.B + JZ       9
+    USCI_DISPATCH_CYCLES_STATE  MOV.B, AND.B, AND.B #15 + JZ  10
+  USCI_B0_I2C_DATA costs one cycle more than USCI_DISPATCH_CYCLES_IFG_IE
+  because its two-flag mask is not a constant-generator value.
+  For example, A0 RX then B0 I2C state: 12 and 22 cycles; B0 I2C data
+  then A0 TX: 16 and 25 cycles. USCI_DISPATCH_CYCLES gives the figure
+  for a sum of entry costs. */
+#define USCI_DISPATCH_CYCLES_IFG    (6U)
+#define USCI_DISPATCH_CYCLES_IFG_IE (9U)
+#define USCI_DISPATCH_CYCLES_STATE  (10U)
+#define USCI_DISPATCH_CYCLES(costs) (6U + (costs)) /* costs: sum of the entry costs up to the handler */
+
+#define USCI_ON_IFG(ifg, handler)    if ((SFR->IFG2 & (ifg)) != 0U) { handler; } else
+#define USCI_ON_IFG_IE(ifg, handler) if ((SFR->IFG2 & SFR->IE2 & (ifg)) != 0U) { handler; } else
+
+#define USCI_A0_RX(handler)        USCI_ON_IFG(IFG2_UCA0RXIFG_MASK, handler)
+#define USCI_A0_TX(handler)        USCI_ON_IFG_IE(IFG2_UCA0TXIFG_MASK, handler)
+#define USCI_B0_RX(handler)        USCI_ON_IFG(IFG2_UCB0RXIFG_MASK, handler) /* SPI mode */
+#define USCI_B0_TX(handler)        USCI_ON_IFG_IE(IFG2_UCB0TXIFG_MASK, handler)
+#define USCI_B0_I2C_DATA(handler)  USCI_ON_IFG_IE(USCI_I2C_DATA_IFG, handler)
+#define USCI_B0_I2C_STATE(handler)                                                                        \
+  if ((UCB0_I2C->STAT & UCB0_I2C->IE &                                                                    \
+       (UCSI_I2C_STAT_UCNACKIFG_MASK | UCSI_I2C_STAT_UCSTPIFG_MASK | UCSI_I2C_STAT_UCSTTIFG_MASK |        \
+        UCSI_I2C_STAT_UCALIFG_MASK)) != 0U) {                                                             \
+    handler;                                                                                              \
+  } else
+
+#define USCI_DISPATCH(...) \
+  do {                     \
+    __VA_ARGS__ {}         \
+  } while (0)
+
 /*****************************************************************************
 * @brief WDT_CTL
 *****************************************************************************/
@@ -2490,6 +4064,15 @@ by: tMIN = (UCIRRXFLx + 4) / (2 ? fBRCLK) */
   11b = Watchdog clock source /64 */
 #define WDT_CTL_WDTIS(x)    (((uint16_t)(((uint16_t)(x)) << WDT_CTL_WDTIS_SHIFT)) & WDT_CTL_WDTIS_MASK)
 
+/* WDT_CTL_WDTIS_DIVIDER */
+/* Clock cycles per interval for a WDTIS value */
+#define WDT_CTL_WDTIS_DIVIDER(is) (((is) == 0U) ? 32768UL : ((is) == 1U) ? 8192UL : ((is) == 2U) ? 512UL : 64UL)
+
+/* WDT_INTERVAL_US */
+/* Interval in microseconds for a WDTIS value with the WDT clocked at fclk Hz,
+  e.g. WDT_INTERVAL_US(MSP430_SMCLK_HZ, 0U) for WDT_MDLY_32 */
+#define WDT_INTERVAL_US(fclk, is) ((WDT_CTL_WDTIS_DIVIDER(is) * 1000000ULL) / (fclk))
+
 #define WDTIS0   (0x0001)
 #define WDTIS1   (0x0002)
 #define WDTSSEL  (0x0004)
@@ -2529,6 +4112,504 @@ by: tMIN = (UCIRRXFLx + 4) / (2 ? fBRCLK) */
 #define TAG_ADC10_1            (0x10)    /* Tag for ADC10_1 Calibration Data */
 #define TAG_EMPTY              (0xFE)    /* Tag for Empty Data Field in Calibration Data */
 
+/* TLV_ADC10_CAL_VALID */
+/* Non-zero when the TLV holds the ADC10 calibration block */
+#define TLV_ADC10_CAL_VALID    (TLV->TAG_2 == TAG_ADC10_1)
+
+/* ADC10_CAL_CORRECT */
+/* Gain and offset corrected conversion result. gain is CAL_ADC_GAIN_FACTOR
+  (1.15 fixed point) and offset is CAL_ADC_OFFSET (signed counts). */
+#define ADC10_CAL_CORRECT(raw, gain, offset) \
+  ((int16_t)((((uint32_t)(uint16_t)(raw)) * ((uint16_t)(gain))) >> 15) + (int16_t)(offset))
+
+/* ADC10_CAL_VREF */
+/* Reference corrected conversion result. factor is CAL_ADC_15.VREF_FACTOR
+  or CAL_ADC_25.VREF_FACTOR (1.15 fixed point). */
+#define ADC10_CAL_VREF(raw, factor) \
+  ((uint16_t)((((uint32_t)(uint16_t)(raw)) * ((uint16_t)(factor))) >> 15))
+
+/* ADC10_CAL_TEMP_SCALE */
+/* 0.16 fixed point degrees per count, computed once at boot from T30 and
+  T85 of the reference in use. This is the only division needed; the
+  result always fits 16 bits because T85 - T30 exceeds 55 counts with
+  either internal reference. */
+#define ADC10_CAL_TEMP_SCALE(t30, t85) \
+  ((uint16_t)((((uint32_t)(85U - 30U)) << 16) / (uint16_t)((uint16_t)(t85) - (uint16_t)(t30))))
+
+/* ADC10_CAL_TEMP */
+/* Temperature in degrees C from a raw temperature sensor conversion,
+  using the scale from ADC10_CAL_TEMP_SCALE. Rounded to nearest. */
+#define ADC10_CAL_TEMP(raw, t30, scale) \
+  ((int16_t)((((int32_t)((int16_t)(raw) - (int16_t)(t30)) * (int32_t)(uint16_t)(scale)) + 0x8000L) >> 16) + 30)
+
+/*****************************************************************************
+* @brief Timer service
+*****************************************************************************/
+
+/* Tickless software timers on CCR1 of TA0 or TA1.
+  TA_TIMERS_INIT runs the timer continuously from ACLK, so it keeps
+  counting in LPM3. Pending TA_TIMER_Type entries form a list sorted by
+  DUE, and only the earliest deadline is loaded into CCR1, so the CPU
+  wakes when a timer expires and not on a periodic tick. Deadlines
+  further out than TA_TIMERS_HORIZON ticks, and an empty list, get an
+  intermediate wake, which keeps the 32-bit tick count extended from
+  TA_TIMERS_INIT on; at 32768 Hz that is one wake per second while idle.
+  TA_TIMER_START inserts from the latest deadline backwards, so timers
+  with equal durations, the usual case for timeouts, are appended in
+  O(1); TA_TIMER_STOP unlinks in O(1). Both edit the list with GIE
+  cleared and restore the previous GIE state afterwards, so the main
+  loop and any interrupt handler can call them; a start that has to
+  scan far back in a long list extends that interrupt lock. TA_TIMERS_NOW
+  updates the service state and is only called with interrupts
+  disabled; TA_TIMERS_TIME is the locked form for reading the time.
+  TA_TIMERS_IRQ runs in TIMER0_A1_VECTOR or TIMER1_A1_VECTOR when TAxIV
+  reads 2 (CCR1); it calls FN for every expired timer. FN may start
+  timers again; TA_TIMER_AGAIN reschedules relative to the previous
+  deadline for drift-free periodic timers. The counter is read until
+  two reads agree because ACLK is asynchronous to MCLK. When a deadline
+  has already passed by the time CCR1 is written, CCIFG is set by
+  software so the interrupt is not lost. */
+#define TA_TIMERS_HORIZON (0x8000UL) /* Longest CCR1 step, half the counter range */
+
+/* Saves GIE in sr and disables interrupts; DINT takes effect after the next instruction */
+#define TA_TIMERS_LOCK_(sr)                                                                               \
+  do {                                                                                                    \
+    (sr) = (uint16_t)(__get_SR_register() & GIE);                                                         \
+    __bic_SR_register(GIE);                                                                               \
+    __no_operation();                                                                                     \
+  } while (0)
+#define TA_TIMERS_UNLOCK_(sr) __bis_SR_register(sr)
+
+#define TA_CTL_TIMERS(id) \
+  (TA_CTL_TASSEL(TA_CTL_TASSEL_ACLK) | TA_CTL_ID(id) | TA_CTL_MC(TA_CTL_MC_CONT) | TA_CTL_TACLR(1U))
+
+/* Timer ticks for ms milliseconds or us microseconds from a timer clock of fclk Hz and input divider id */
+#define TA_TIMER_TICKS_MS(ms, fclk, id) ((uint32_t)(((uint64_t)(ms) * ((fclk) >> (id))) / 1000U))
+#define TA_TIMER_TICKS_US(us, fclk, id) ((uint32_t)(((uint64_t)(us) * ((fclk) >> (id))) / 1000000U))
+
+/* Prepares an idle timer calling fn. TA_TIMER_ACTIVE relies on PREV and
+  NEXT being 0 while the timer is not linked, so every TA_TIMER_Type goes
+  through TA_TIMER_INIT (or static zero initialization) before its first
+  TA_TIMER_START; the service keeps them that way after TA_TIMER_STOP and
+  expiry. */
+#define TA_TIMER_INIT(t, fn) ((t)->NEXT = 0, (t)->PREV = 0, (t)->DUE = 0UL, (t)->FN = (fn))
+
+#define TA_TIMER_ACTIVE(svc, t) (((t)->PREV != 0) || ((svc).HEAD == (t)))
+
+#define TA_R_STABLE_(ta, r)                                                                               \
+  do {                                                                                                    \
+    (r) = (ta)->R;                                                                                        \
+    while ((r) != (ta)->R) {                                                                              \
+      (r) = (ta)->R;                                                                                      \
+    }                                                                                                     \
+  } while (0)
+
+#define TA_TIMERS_NOW(ta, svc, now)                                                                       \
+  do {                                                                                                    \
+    uint16_t r_;                                                                                          \
+    TA_R_STABLE_(ta, r_);                                                                                 \
+    if (r_ < (svc).LAST) {                                                                                \
+      (svc).HI++;                                                                                         \
+    }                                                                                                     \
+    (svc).LAST = r_;                                                                                      \
+    (now) = ((uint32_t)(svc).HI << 16) | r_;                                                              \
+  } while (0)
+
+#define TA_TIMERS_ARM_(ta, svc, now)                                                                      \
+  do {                                                                                                    \
+    uint16_t r_;                                                                                          \
+    (ta)->CCTL[1] &= (uint16_t)~TA_CCTL_CCIFG_MASK;                                                       \
+    if (((svc).HEAD != 0) && ((int32_t)((svc).HEAD->DUE - (now)) <= (int32_t)TA_TIMERS_HORIZON)) {        \
+      (ta)->CCR[1] = (uint16_t)(svc).HEAD->DUE;                                                           \
+    } else {                                                                                              \
+      (ta)->CCR[1] = (uint16_t)((now) + TA_TIMERS_HORIZON);                                               \
+    }                                                                                                     \
+    TA_R_STABLE_(ta, r_);                                                                                 \
+    if ((int16_t)(r_ - (ta)->CCR[1]) >= 0) {                                                              \
+      (ta)->CCTL[1] |= TA_CCTL_CCIFG_MASK;                                                                \
+    }                                                                                                     \
+    (ta)->CCTL[1] |= TA_CCTL_CCIE_MASK;                                                                   \
+  } while (0)
+
+/* Starts the timer with input divider id and an empty service */
+#define TA_TIMERS_INIT(ta, svc, id)                                                                       \
+  do {                                                                                                    \
+    (ta)->CTL = TA_CTL_TIMERS(id);                                                                        \
+    (svc).HEAD = 0;                                                                                       \
+    (svc).TAIL = 0;                                                                                       \
+    (svc).HI = 0U;                                                                                        \
+    (svc).LAST = 0U;                                                                                      \
+    TA_TIMERS_ARM_(ta, svc, 0UL);                                                                         \
+  } while (0)
+
+#define TA_TIMERS_TIME(ta, svc, now)                                                                      \
+  do {                                                                                                    \
+    uint16_t sr_;                                                                                         \
+    TA_TIMERS_LOCK_(sr_);                                                                                 \
+    TA_TIMERS_NOW(ta, svc, now);                                                                          \
+    TA_TIMERS_UNLOCK_(sr_);                                                                               \
+  } while (0)
+
+#define TA_TIMER_UNLINK_(svc, t)                                                                          \
+  do {                                                                                                    \
+    if ((t)->PREV != 0) {                                                                                 \
+      (t)->PREV->NEXT = (t)->NEXT;                                                                        \
+    } else {                                                                                              \
+      (svc).HEAD = (t)->NEXT;                                                                             \
+    }                                                                                                     \
+    if ((t)->NEXT != 0) {                                                                                 \
+      (t)->NEXT->PREV = (t)->PREV;                                                                        \
+    } else {                                                                                              \
+      (svc).TAIL = (t)->PREV;                                                                             \
+    }                                                                                                     \
+    (t)->NEXT = 0;                                                                                        \
+    (t)->PREV = 0;                                                                                        \
+  } while (0)
+
+#define TA_TIMER_INSERT_(svc, t)                                                                          \
+  do {                                                                                                    \
+    TA_TIMER_Type *p_ = (svc).TAIL;                                                                       \
+    while ((p_ != 0) && ((int32_t)(p_->DUE - (t)->DUE) > 0)) {                                            \
+      p_ = p_->PREV;                                                                                      \
+    }                                                                                                     \
+    (t)->PREV = p_;                                                                                       \
+    if (p_ != 0) {                                                                                        \
+      (t)->NEXT = p_->NEXT;                                                                               \
+      p_->NEXT = (t);                                                                                     \
+    } else {                                                                                              \
+      (t)->NEXT = (svc).HEAD;                                                                             \
+      (svc).HEAD = (t);                                                                                   \
+    }                                                                                                     \
+    if ((t)->NEXT != 0) {                                                                                 \
+      (t)->NEXT->PREV = (t);                                                                              \
+    } else {                                                                                              \
+      (svc).TAIL = (t);                                                                                   \
+    }                                                                                                     \
+  } while (0)
+
+/* due may use now_, the current tick count */
+#define TA_TIMER_SET_(ta, svc, t, due)                                                                    \
+  do {                                                                                                    \
+    uint32_t now_;                                                                                        \
+    uint16_t sr_;                                                                                         \
+    TA_TIMERS_LOCK_(sr_);                                                                                 \
+    TA_TIMERS_NOW(ta, svc, now_);                                                                         \
+    (t)->DUE = (due);                                                                                     \
+    if (TA_TIMER_ACTIVE(svc, t)) {                                                                        \
+      TA_TIMER_UNLINK_(svc, t);                                                                           \
+    }                                                                                                     \
+    TA_TIMER_INSERT_(svc, t);                                                                             \
+    TA_TIMERS_ARM_(ta, svc, now_);                                                                        \
+    TA_TIMERS_UNLOCK_(sr_);                                                                               \
+  } while (0)
+
+#define TA_TIMER_START(ta, svc, t, ticks) TA_TIMER_SET_(ta, svc, t, now_ + (uint32_t)(ticks))
+#define TA_TIMER_AGAIN(ta, svc, t, ticks) TA_TIMER_SET_(ta, svc, t, (t)->DUE + (uint32_t)(ticks))
+
+#define TA_TIMER_STOP(ta, svc, t)                                                                         \
+  do {                                                                                                    \
+    uint32_t now_;                                                                                        \
+    uint16_t sr_;                                                                                         \
+    TA_TIMERS_LOCK_(sr_);                                                                                 \
+    if (TA_TIMER_ACTIVE(svc, t)) {                                                                        \
+      TA_TIMER_UNLINK_(svc, t);                                                                           \
+    }                                                                                                     \
+    TA_TIMERS_NOW(ta, svc, now_);                                                                         \
+    TA_TIMERS_ARM_(ta, svc, now_);                                                                        \
+    TA_TIMERS_UNLOCK_(sr_);                                                                               \
+  } while (0)
+
+#define TA_TIMERS_IRQ(ta, svc)                                                                            \
+  do {                                                                                                    \
+    uint32_t now_;                                                                                        \
+    TA_TIMER_Type *t_;                                                                                    \
+    TA_TIMERS_NOW(ta, svc, now_);                                                                         \
+    while (((t_ = (svc).HEAD) != 0) && ((int32_t)(t_->DUE - now_) <= 0)) {                                \
+      TA_TIMER_UNLINK_(svc, t_);                                                                          \
+      t_->FN(t_);                                                                                         \
+    }                                                                                                     \
+    TA_TIMERS_NOW(ta, svc, now_);                                                                         \
+    TA_TIMERS_ARM_(ta, svc, now_);                                                                        \
+  } while (0)
+
+/*****************************************************************************
+* @brief PWM
+*****************************************************************************/
+
+/* Hardware PWM on CCR1/CCR2 of TA0 and TA1 (TA0.1, TA0.2, TA1.1, TA1.2
+  through PxSEL), in up mode (TA_CTL_MC_UPTOCCR0) or center-aligned
+  up/down mode (TA_CTL_MC_UPDOWN). CCR0, the divider and the duty
+  resolution in steps come from TA_PWM_CCR0/TA_PWM_CTL/TA_PWM_STEPS at
+  compile time. Timer_A compare registers have no shadow latch, so a duty
+  written mid-period can skip an edge and produce a runt or a full-period
+  pulse. Duties are therefore staged in a TA_PWM_Type with TA_PWM_STAGE
+  and written to the timer by TA_PWM_IRQ in TIMER0_A0_VECTOR or
+  TIMER1_A0_VECTOR at the next CCR0 event, both channels of a timer in
+  the same period; TA_PWM_COMMIT arms it, TA_PWM_SET does both. CCR0
+  is the point where every output is low: up mode uses set/reset output
+  (pulse trailing-aligned to CCR0) and up/down mode toggle/reset output
+  (pulse centered on the counter valley), so a new value only has to be
+  in place before the counter reaches it again. TA_PWM_CCR clamps duties
+  to TA_PWM_STEPS - lead, where lead (TA_PWM_LEAD) covers the
+  TA_PWM_COMMIT_CYCLES MCLK cycles from the CCR0 event to the last
+  compare write; add the longest other ISR when interrupts can delay
+  TA_PWM_IRQ. A duty of 0 never sets the output, so off is exact. A new
+  duty reaches the output within TA_PWM_LATENCY_MAX_TICKS timer clocks
+  of TA_PWM_COMMIT: the wait for the next CCR0 event plus the period that
+  carries the first new edge. CCR0 must stay below 0xffff, which
+  encodes the never-matching compare of a duty of 0; TA_PWM_ID picks
+  the divider accordingly and TA_PWM_IN_RANGE tells when no divider
+  does. */
+#ifndef TA_PWM_COMMIT_CYCLES
+#define TA_PWM_COMMIT_CYCLES (20U) /* Interrupt entry and two indexed CCR writes */
+#endif
+
+/* Smallest input divider for which TA_PERIOD_TICKS of rate Hz is at most max */
+#define TA_PWM_ID_FOR_(fclk, rate, max) \
+  ((TA_PERIOD_TICKS(fclk, TA_CTL_ID_1, rate) <= (max)) ? TA_CTL_ID_1 : \
+   (TA_PERIOD_TICKS(fclk, TA_CTL_ID_2, rate) <= (max)) ? TA_CTL_ID_2 : \
+   (TA_PERIOD_TICKS(fclk, TA_CTL_ID_4, rate) <= (max)) ? TA_CTL_ID_4 : TA_CTL_ID_8)
+
+/* Most timer clocks per counted span that keep CCR0 at or below 0xfffe:
+  the span is CCR0 + 1 clocks in up mode and CCR0 in up/down mode */
+#define TA_PWM_TICKS_MAX(mc) (((mc) == TA_CTL_MC_UPDOWN) ? 0xfffeUL : 0xffffUL)
+
+/* Timer clocks counted per PWM period (up) or half period (up/down) */
+#define TA_PWM_RATE_(rate, mc) (((mc) == TA_CTL_MC_UPDOWN) ? 2UL * (rate) : (rate))
+
+/* Input divider (TA_CTL_ID_x value) for a PWM rate of rate Hz */
+#define TA_PWM_ID(fclk, rate, mc) TA_PWM_ID_FOR_(fclk, TA_PWM_RATE_(rate, mc), TA_PWM_TICKS_MAX(mc))
+
+/* Timer clocks per counted span with the divider from TA_PWM_ID */
+#define TA_PWM_TICKS_(fclk, rate, mc) \
+  TA_PERIOD_TICKS(fclk, TA_PWM_ID(fclk, rate, mc), TA_PWM_RATE_(rate, mc))
+
+/* CCR0 for a PWM rate of rate Hz; up/down mode counts CCR0 twice per period */
+#define TA_PWM_CCR0(fclk, rate, mc) \
+  ((uint16_t)(TA_PWM_TICKS_(fclk, rate, mc) - (((mc) == TA_CTL_MC_UPDOWN) ? 0UL : 1UL)))
+
+/* Non-zero when TA_PWM_CCR0 is usable: at least 2 duty steps and CCR0
+  below 0xffff after /8. Check it at compile time, e.g.
+  MSP430_STATIC_ASSERT(TA_PWM_IN_RANGE(fclk, rate, mc), "PWM rate"). */
+#define TA_PWM_IN_RANGE(fclk, rate, mc) \
+  ((TA_PERIOD_TICKS(fclk, TA_CTL_ID_1, TA_PWM_RATE_(rate, mc)) >= 2UL) && \
+   (TA_PWM_TICKS_(fclk, rate, mc) <= TA_PWM_TICKS_MAX(mc)))
+
+/* Duty resolution: a duty of TA_PWM_STEPS is 100 % */
+#define TA_PWM_STEPS(fclk, rate, mc)                                                                      \
+  ((uint16_t)(((mc) == TA_CTL_MC_UPDOWN) ? TA_PWM_CCR0(fclk, rate, mc) : TA_PWM_CCR0(fclk, rate, mc) + 1UL))
+
+#define TA_PWM_CTL(tassel, fclk, rate, mc)                                                                \
+  (TA_CTL_TASSEL(tassel) | TA_CTL_ID(TA_PWM_ID(fclk, rate, mc)) | TA_CTL_MC(mc) | TA_CTL_TACLR(1U))
+
+#define TA_PWM_CCTL(mc)                                                                                   \
+  TA_CCTL_OUTMOD(((mc) == TA_CTL_MC_UPDOWN) ? TA_CCTL_OUTMOD_PWM_TOGGLE_RESET : TA_CCTL_OUTMOD_PWM_SET_RESET)
+
+/* Timer clocks (timer clock tclk Hz, after the divider) covering TA_PWM_COMMIT_CYCLES at MCLK mclk Hz */
+#define TA_PWM_LEAD(mclk, tclk) ((uint16_t)(((uint32_t)TA_PWM_COMMIT_CYCLES * (tclk) + (mclk) - 1UL) / (mclk) + 1UL))
+
+#define TA_PWM_LATENCY_MAX_TICKS(steps, mc) (((mc) == TA_CTL_MC_UPDOWN) ? 3UL * (steps) : 2UL * (steps))
+
+/* Compare value for duty d of steps, clamped to steps - lead */
+#define TA_PWM_CCR_(steps, mc, d) (((d) == 0U) ? 0xffffU : ((mc) == TA_CTL_MC_UPDOWN) ? (d) : ((steps) - 1U - (d)))
+#define TA_PWM_CCR(steps, lead, mc, d)                                                                    \
+  ((uint16_t)(((d) > (steps) - (lead)) ? TA_PWM_CCR_(steps, mc, (steps) - (lead))                         \
+                                       : TA_PWM_CCR_(steps, mc, d)))
+
+/* Stops the timer, loads the staged duties and starts it with ctl from TA_PWM_CTL */
+#define TA_PWM_START(ta, pwm, ctl, ccr0, mc)                                                              \
+  do {                                                                                                    \
+    uint8_t c_;                                                                                           \
+    (ta)->CTL = 0U;                                                                                       \
+    (ta)->CCTL[0] = 0U;                                                                                   \
+    (ta)->CCR[0] = (ccr0);                                                                                \
+    for (c_ = 1U; c_ < 3U; c_++) {                                                                        \
+      (ta)->CCR[c_] = (pwm).CCR[c_ - 1U];                                                                 \
+      (ta)->CCTL[c_] = TA_CCTL_OUT(((mc) == TA_CTL_MC_UPDOWN) && ((pwm).CCR[c_ - 1U] <= (ccr0)));         \
+      (ta)->CCTL[c_] = TA_PWM_CCTL(mc);                                                                   \
+    }                                                                                                     \
+    (ta)->CTL = (ctl);                                                                                    \
+  } while (0)
+
+/* ch is 1 or 2; ccr from TA_PWM_CCR */
+#define TA_PWM_STAGE(ta, pwm, ch, ccr)                                                                    \
+  do {                                                                                                    \
+    (ta)->CCTL[0] &= (uint16_t)~TA_CCTL_CCIE_MASK;                                                        \
+    (pwm).CCR[(ch) - 1U] = (ccr);                                                                         \
+  } while (0)
+
+/* CCIFG is set every period, so a stale flag is dropped before arming */
+#define TA_PWM_COMMIT(ta)                                                                                 \
+  do {                                                                                                    \
+    (ta)->CCTL[0] &= (uint16_t)~TA_CCTL_CCIFG_MASK;                                                       \
+    (ta)->CCTL[0] |= TA_CCTL_CCIE_MASK;                                                                   \
+  } while (0)
+
+#define TA_PWM_SET(ta, pwm, ch, ccr)                                                                      \
+  do {                                                                                                    \
+    TA_PWM_STAGE(ta, pwm, ch, ccr);                                                                       \
+    TA_PWM_COMMIT(ta);                                                                                    \
+  } while (0)
+
+#define TA_PWM_IRQ(ta, pwm)                                                                               \
+  do {                                                                                                    \
+    (ta)->CCR[1] = (pwm).CCR[0];                                                                          \
+    (ta)->CCR[2] = (pwm).CCR[1];                                                                          \
+    (ta)->CCTL[0] &= (uint16_t)~TA_CCTL_CCIE_MASK;                                                        \
+  } while (0)
+
+/*****************************************************************************
+* @brief Ring buffer indexes
+*****************************************************************************/
+
+/* Lock-free single-producer/single-consumer ring buffer index helpers.
+  head is only written by the producer and tail only by the consumer. Both
+  are free-running uint8_t counters, and n is a power of two no larger
+  than 128. Byte reads and writes are atomic on the MSP430, so an ISR and
+  the main loop can share a ring without disabling interrupts. */
+#define RING_IS_POW2(n)          (((n) != 0U) && (((n) & ((n) - 1U)) == 0U))
+#define RING_COUNT(head, tail)   ((uint8_t)((uint8_t)(head) - (uint8_t)(tail))) /* Used entries */
+#define RING_EMPTY(head, tail)   ((uint8_t)(head) == (uint8_t)(tail))
+#define RING_FULL(head, tail, n) (RING_COUNT(head, tail) >= (n))
+#define RING_SLOT(index, n)      ((uint8_t)((index) & ((n) - 1U))) /* Array position of a counter value */
+
+/*****************************************************************************
+* @brief Stream framing
+*****************************************************************************/
+
+/* CRC-16/CCITT (polynomial 0x1021, MSB first) four bits at a time from a
+  16-entry table, 32 bytes of flash instead of 512. The table is
+  instantiated once, e.g.
+    static const uint16_t crc16_tab[16] = CRC16_CCITT_NIBBLE_TABLE;
+  Starting from CRC16_CCITT_INIT and running CRC16_UPDATE over a packet
+  followed by its own CRC (high byte first) leaves 0, so a receiver that
+  updates the CRC as bytes are decoded has checked the packet when the
+  delimiter arrives. */
+#define CRC16_CCITT_INIT (0xffffU)
+
+#define CRC16_CCITT_NIBBLE_TABLE                                                                            \
+  {0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50a5U, 0x60c6U, 0x70e7U,                                  \
+   0x8108U, 0x9129U, 0xa14aU, 0xb16bU, 0xc18cU, 0xd1adU, 0xe1ceU, 0xf1efU}
+
+#define CRC16_NIBBLE_(crc, tab, x) ((uint16_t)((uint16_t)((crc) << 4) ^ (tab)[((crc) >> 12) ^ ((x) & 0xfU)]))
+#define CRC16_UPDATE(crc, tab, b)  ((crc) = CRC16_NIBBLE_(crc, tab, (uint8_t)(b) >> 4), (crc) = CRC16_NIBBLE_(crc, tab, (uint8_t)(b)))
+
+/* Streaming COBS, one byte per handler run and no intermediate buffer.
+  Receive: on a non-zero byte c, with len < the buffer size, call
+  COBS_DECODE; it stores at most one byte and folds it into crc. On the
+  0x00 delimiter the packet is complete when COBS_DECODE_OK holds and
+  crc is 0; then clear len, rem and blk and reload crc for the next one.
+  Transmit: the packet (with its CRC appended) stays in place in src[n].
+  A COBS_ENCODE call with ready = 1 yields the next wire byte in out;
+  out == 0 is the delimiter and ends the packet. Before the first call
+  pos, rem and blk are 0; pos counts up to n + 1, so it needs to be wider
+  than n. A block code needs a look-ahead of up to 254 bytes, which is
+  spread over calls at COBS_SCAN_MAX bytes each: a call that runs out of
+  scan budget returns ready = 0 and the TX handler returns without
+  writing TXBUF. TXIFG stays set, so the handler runs again, and
+  USCIAB0RX_VECTOR, which has the higher priority, is served in
+  between. */
+#ifndef COBS_SCAN_MAX
+#define COBS_SCAN_MAX (16U) /* Look-ahead bytes per COBS_ENCODE call */
+#endif
+
+#define COBS_DECODE(buf, len, rem, blk, crc, tab, c)                                                        \
+  do {                                                                                                      \
+    if ((rem) == 0U) {                                                                                      \
+      if (((blk) != 0U) && ((blk) != 0xffU)) {                                                              \
+        (buf)[(len)++] = 0U;                                                                                \
+        CRC16_UPDATE(crc, tab, 0U);                                                                         \
+      }                                                                                                     \
+      (blk) = (uint8_t)(c);                                                                                 \
+      (rem) = (uint8_t)((blk) - 1U);                                                                        \
+    } else {                                                                                                \
+      (buf)[(len)++] = (uint8_t)(c);                                                                        \
+      CRC16_UPDATE(crc, tab, c);                                                                            \
+      (rem)--;                                                                                              \
+    }                                                                                                       \
+  } while (0)
+
+#define COBS_DECODE_OK(rem, blk) (((rem) == 0U) && ((blk) != 0U))
+
+#define COBS_ENCODE(src, n, pos, rem, blk, out, ready)                                                      \
+  do {                                                                                                      \
+    uint8_t k_ = COBS_SCAN_MAX;                                                                             \
+    (ready) = 1U;                                                                                           \
+    if ((blk) != 0U) {                                                                                      \
+      if ((rem) != 0U) {                                                                                    \
+        (out) = (src)[(pos)++];                                                                             \
+        (rem)--;                                                                                            \
+        break;                                                                                              \
+      }                                                                                                     \
+      if ((blk) != 0xffU) {                                                                                 \
+        (pos)++; /* The zero that ended the block, or the implicit one after src */                         \
+      }                                                                                                     \
+      (blk) = 0U; /* Scanning for the next block */                                                         \
+      if ((pos) > (n)) {                                                                                    \
+        (out) = 0U;                                                                                         \
+        break;                                                                                              \
+      }                                                                                                     \
+    }                                                                                                       \
+    while ((((pos) + (rem)) < (n)) && ((rem) < 254U) && ((src)[(pos) + (rem)] != 0U)) {                     \
+      if (k_ == 0U) {                                                                                       \
+        (ready) = 0U;                                                                                       \
+        break;                                                                                              \
+      }                                                                                                     \
+      k_--;                                                                                                 \
+      (rem)++;                                                                                              \
+    }                                                                                                       \
+    if ((ready) == 0U) {                                                                                    \
+      break;                                                                                                \
+    }                                                                                                       \
+    (blk) = (uint8_t)((rem) + 1U);                                                                          \
+    (out) = (blk);                                                                                          \
+  } while (0)
+
+/* Streaming SLIP (RFC 1055), the alternative when frames rarely contain
+  0xc0/0xdb. Receive: call SLIP_DECODE for every byte other than
+  SLIP_END, with len < the buffer size; SLIP_END completes the packet,
+  which is valid when crc is 0. Transmit: SLIP_ENCODE yields the next wire
+  byte from src[n] and out == SLIP_END ends the packet; pos and esc start
+  at 0. */
+#define SLIP_END     (0xc0U) /* Frame delimiter */
+#define SLIP_ESC     (0xdbU) /* Escape */
+#define SLIP_ESC_END (0xdcU) /* Escaped SLIP_END */
+#define SLIP_ESC_ESC (0xddU) /* Escaped SLIP_ESC */
+
+#define SLIP_DECODE(buf, len, esc, crc, tab, c)                                                             \
+  do {                                                                                                      \
+    uint8_t c_ = (uint8_t)(c);                                                                              \
+    if (c_ == SLIP_ESC) {                                                                                   \
+      (esc) = 1U;                                                                                           \
+      break;                                                                                                \
+    }                                                                                                       \
+    if ((esc) != 0U) {                                                                                      \
+      (esc) = 0U;                                                                                           \
+      c_ = (c_ == SLIP_ESC_END) ? SLIP_END : ((c_ == SLIP_ESC_ESC) ? SLIP_ESC : c_);                        \
+    }                                                                                                       \
+    (buf)[(len)++] = c_;                                                                                    \
+    CRC16_UPDATE(crc, tab, c_);                                                                             \
+  } while (0)
+
+#define SLIP_ENCODE(src, n, pos, esc, out)                                                                  \
+  do {                                                                                                      \
+    if ((esc) != 0U) {                                                                                      \
+      (out) = (esc);                                                                                        \
+      (esc) = 0U;                                                                                           \
+      (pos)++;                                                                                              \
+    } else if ((pos) >= (n)) {                                                                              \
+      (out) = SLIP_END;                                                                                     \
+    } else if ((src)[pos] == SLIP_END) {                                                                    \
+      (out) = SLIP_ESC;                                                                                     \
+      (esc) = SLIP_ESC_END;                                                                                 \
+    } else if ((src)[pos] == SLIP_ESC) {                                                                    \
+      (out) = SLIP_ESC;                                                                                     \
+      (esc) = SLIP_ESC_ESC;                                                                                 \
+    } else {                                                                                                \
+      (out) = (src)[(pos)++];                                                                               \
+    }                                                                                                       \
+  } while (0)
+
 /************************************************************
 * Interrupt Vectors (offset from 0xFFE0)
 ************************************************************/